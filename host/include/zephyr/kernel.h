@@ -0,0 +1,620 @@
+// SPDX-License-Identifier: Apache-2.0
+/// @file
+/// @brief  The subset of the Zephyr kernel API that the zephyrrtos-mcpp wrappers use,
+///         implemented on pthreads, futexes and CLOCK_MONOTONIC (see host/src/),
+///         so that application logic and benchmarks can run natively on Linux.
+///         The kernel objects keep their Zephyr semantics, with these differences:
+///         - threads are scheduled by the host, priorities are only stored,
+///           the given stacks are left unused, threads run on the pthread stacks
+///         - there are no interrupts, irq_lock() is a global recursive lock,
+///           released while the holder is blocked in the kernel, like on target
+///         - k_sched_lock() has no effect, host threads run in parallel anyway
+///         - a tick is a microsecond, a cycle is a nanosecond
+#pragma once
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/spinlock.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/dlist.h>
+#include <zephyr/sys/iterable_sections.h>
+#include <zephyr/sys/slist.h>
+#include <zephyr/sys/util.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifdef CONFIG_ASSERT
+#include <assert.h>
+#define __ASSERT(test, fmt, ...) assert(test)
+#define __ASSERT_NO_MSG(test) assert(test)
+#else
+#define __ASSERT(test, fmt, ...) ((void)0)
+#define __ASSERT_NO_MSG(test) ((void)0)
+#endif
+
+#define __noinit
+
+#ifndef CONFIG_THREAD_MAX_NAME_LEN
+#define CONFIG_THREAD_MAX_NAME_LEN 32
+#endif
+
+// --- time ---
+
+#define Z_HZ_ticks 1000000
+#define Z_HZ_cyc 1000000000
+
+typedef int64_t k_ticks_t;
+
+typedef struct
+{
+    k_ticks_t ticks;
+} k_timeout_t;
+
+#define K_TICKS_FOREVER ((k_ticks_t)-1)
+#ifdef __cplusplus
+#define Z_TIMEOUT_TICKS(t) (k_timeout_t{(k_ticks_t)(t)})
+#else
+#define Z_TIMEOUT_TICKS(t) ((k_timeout_t){.ticks = (t)})
+#endif
+#define Z_TICK_ABS(t) (K_TICKS_FOREVER - 1 - (t))
+#define K_NO_WAIT Z_TIMEOUT_TICKS(0)
+#define K_FOREVER Z_TIMEOUT_TICKS(K_TICKS_FOREVER)
+#define K_TIMEOUT_EQ(a, b) ((a).ticks == (b).ticks)
+#define K_TIMEOUT_ABS_TICKS(t) Z_TIMEOUT_TICKS(Z_TICK_ABS((k_ticks_t)MAX((t), 0)))
+#define K_TICKS(t) Z_TIMEOUT_TICKS(t)
+#define K_NSEC(t) Z_TIMEOUT_TICKS(((k_ticks_t)(t) + 999) / 1000)
+#define K_USEC(t) Z_TIMEOUT_TICKS((k_ticks_t)(t))
+#define K_MSEC(t) Z_TIMEOUT_TICKS((k_ticks_t)(t) * 1000)
+#define K_SECONDS(t) Z_TIMEOUT_TICKS((k_ticks_t)(t) * 1000000)
+
+static inline uint64_t k_cyc_to_ns_floor64(uint64_t c)
+{
+    return c;
+}
+static inline uint64_t k_cyc_to_us_floor64(uint64_t c)
+{
+    return c / 1000;
+}
+static inline uint64_t k_cyc_to_ticks_floor64(uint64_t c)
+{
+    return c / 1000;
+}
+static inline uint64_t k_ns_to_cyc_ceil64(uint64_t ns)
+{
+    return ns;
+}
+static inline uint64_t k_us_to_cyc_ceil64(uint64_t us)
+{
+    return us * 1000;
+}
+static inline uint64_t k_ticks_to_cyc_floor64(uint64_t t)
+{
+    return t * 1000;
+}
+static inline uint64_t k_ns_to_ticks_ceil64(uint64_t ns)
+{
+    return (ns + 999) / 1000;
+}
+static inline uint64_t k_us_to_ticks_ceil64(uint64_t us)
+{
+    return us;
+}
+static inline uint64_t k_ms_to_ticks_ceil64(uint64_t ms)
+{
+    return ms * 1000;
+}
+static inline uint64_t k_ticks_to_us_floor64(uint64_t t)
+{
+    return t;
+}
+static inline uint64_t k_ticks_to_ms_floor64(uint64_t t)
+{
+    return t / 1000;
+}
+static inline uint32_t sys_clock_hw_cycles_per_sec(void)
+{
+    return Z_HZ_cyc;
+}
+
+/// @brief  The time since the process start, in ticks.
+k_ticks_t k_uptime_ticks(void);
+/// @brief  The time since the process start, in milliseconds.
+int64_t k_uptime_get(void);
+uint32_t k_uptime_get_32(void);
+uint32_t k_cycle_get_32(void);
+uint64_t k_cycle_get_64(void);
+
+// --- execution context ---
+
+static inline bool k_is_in_isr(void)
+{
+    return false;
+}
+static inline unsigned int arch_num_cpus(void)
+{
+    return 1;
+}
+unsigned int irq_lock(void);
+void irq_unlock(unsigned int key);
+static inline void k_sched_lock(void) {}
+static inline void k_sched_unlock(void) {}
+
+// --- threads ---
+
+typedef void (*k_thread_entry_t)(void* p1, void* p2, void* p3);
+
+typedef struct z_thread_stack_element
+{
+    char data;
+} k_thread_stack_t;
+
+#define K_KERNEL_STACK_RESERVED ((size_t)0)
+#define K_KERNEL_STACK_MEMBER(sym, size) k_thread_stack_t sym[size]
+#define K_KERNEL_STACK_DEFINE(sym, size) k_thread_stack_t sym[size]
+#define K_KERNEL_STACK_SIZEOF(sym) (sizeof(sym) - K_KERNEL_STACK_RESERVED)
+#define K_THREAD_STACK_ARRAY_DEFINE(sym, nmemb, size) k_thread_stack_t sym[nmemb][size]
+#define K_THREAD_STACK_DEFINE(sym, size) k_thread_stack_t sym[size]
+#define K_THREAD_STACK_MEMBER(sym, size) k_thread_stack_t sym[size]
+#define K_THREAD_STACK_SIZEOF(sym) (sizeof(sym) - K_KERNEL_STACK_RESERVED)
+
+#define K_ESSENTIAL BIT(0)
+#define K_FP_REGS BIT(1)
+#define K_USER BIT(2)
+#define K_INHERIT_PERMS BIT(3)
+
+#define K_HIGHEST_THREAD_PRIO (-16)
+#define K_LOWEST_THREAD_PRIO 15
+#define K_LOWEST_APPLICATION_THREAD_PRIO (K_LOWEST_THREAD_PRIO - 1)
+#define K_IDLE_PRIO K_LOWEST_THREAD_PRIO
+#define K_PRIO_COOP(x) (-(16 - (x)))
+#define K_PRIO_PREEMPT(x) (x)
+
+struct k_thread
+{
+    pthread_t tid;
+    k_thread_entry_t entry;
+    void* p1;
+    void* p2;
+    void* p3;
+    int prio;
+    k_ticks_t start_delay;
+    uint8_t state;
+    bool suspended;
+    char name[CONFIG_THREAD_MAX_NAME_LEN];
+};
+
+typedef struct k_thread* k_tid_t;
+
+/// @brief  Creates a thread, which runs on its own pthread stack, so the stack is unused.
+k_tid_t k_thread_create(struct k_thread* new_thread, k_thread_stack_t* stack, size_t stack_size,
+                        k_thread_entry_t entry, void* p1, void* p2, void* p3, int prio,
+                        uint32_t options, k_timeout_t delay);
+void k_thread_start(k_tid_t thread);
+int k_thread_join(struct k_thread* thread, k_timeout_t timeout);
+/// @brief  Aborts the calling thread, other threads can't be aborted on the host.
+void k_thread_abort(k_tid_t thread);
+/// @brief  Suspends the thread, the calling thread immediately,
+///         other threads at their next k_sleep() or k_yield() call.
+void k_thread_suspend(k_tid_t thread);
+void k_thread_resume(k_tid_t thread);
+k_tid_t k_current_get(void);
+int k_thread_name_set(k_tid_t thread, const char* str);
+const char* k_thread_name_get(k_tid_t thread);
+int k_thread_priority_get(k_tid_t thread);
+void k_thread_priority_set(k_tid_t thread, int prio);
+void k_yield(void);
+static inline bool k_can_yield(void)
+{
+    return true;
+}
+int k_is_preempt_thread(void);
+int32_t k_sleep(k_timeout_t timeout);
+int32_t k_usleep(int32_t us);
+int32_t k_msleep(int32_t ms);
+void k_busy_wait(uint32_t usec_to_wait);
+
+// --- semaphore ---
+
+struct z_sem_waiter;
+
+struct k_sem
+{
+    unsigned int count;
+    unsigned int limit;
+    /// the threads blocked in k_sem_take, in FIFO order
+    struct z_sem_waiter* first_waiter;
+    struct z_sem_waiter* last_waiter;
+};
+
+#define K_SEM_MAX_LIMIT UINT32_MAX
+#define Z_SEM_INITIALIZER(obj, initial_count, count_limit)                                         \
+    {.count = (initial_count), .limit = (count_limit)}
+#define K_SEM_DEFINE(name, initial_count, count_limit)                                             \
+    STRUCT_SECTION_ITERABLE(k_sem, name) = Z_SEM_INITIALIZER(name, initial_count, count_limit)
+
+int k_sem_init(struct k_sem* sem, unsigned int initial_count, unsigned int limit);
+int k_sem_take(struct k_sem* sem, k_timeout_t timeout);
+void k_sem_give(struct k_sem* sem);
+void k_sem_reset(struct k_sem* sem);
+unsigned int k_sem_count_get(struct k_sem* sem);
+
+// --- mutex and condition variable ---
+
+struct k_mutex
+{
+    struct k_thread* owner;
+    uint32_t lock_count;
+};
+
+#define Z_MUTEX_INITIALIZER(obj) {.owner = NULL, .lock_count = 0}
+#define K_MUTEX_DEFINE(name) STRUCT_SECTION_ITERABLE(k_mutex, name) = Z_MUTEX_INITIALIZER(name)
+
+int k_mutex_init(struct k_mutex* mutex);
+int k_mutex_lock(struct k_mutex* mutex, k_timeout_t timeout);
+int k_mutex_unlock(struct k_mutex* mutex);
+
+struct k_condvar
+{
+    unsigned int waiters;
+    unsigned int wakeups;
+};
+
+#define Z_CONDVAR_INITIALIZER(obj) {.waiters = 0, .wakeups = 0}
+
+int k_condvar_init(struct k_condvar* condvar);
+int k_condvar_signal(struct k_condvar* condvar);
+int k_condvar_broadcast(struct k_condvar* condvar);
+int k_condvar_wait(struct k_condvar* condvar, struct k_mutex* mutex, k_timeout_t timeout);
+
+// --- futex ---
+
+struct k_futex
+{
+    atomic_t val;
+    unsigned int waiters;
+    unsigned int wakeups;
+};
+
+int k_futex_wait(struct k_futex* futex, int expected, k_timeout_t timeout);
+int k_futex_wake(struct k_futex* futex, bool wake_all);
+
+// --- message queue ---
+
+struct k_msgq
+{
+    size_t msg_size;
+    uint32_t max_msgs;
+    char* buffer_start;
+    char* buffer_end;
+    char* read_ptr;
+    char* write_ptr;
+    uint32_t used_msgs;
+    uint8_t flags;
+};
+
+struct k_msgq_attrs
+{
+    size_t msg_size;
+    uint32_t max_msgs;
+    uint32_t used_msgs;
+};
+
+#define Z_MSGQ_INITIALIZER(obj, q_buffer, q_msg_size, q_max_msgs)                                 \
+    {.msg_size = (q_msg_size),                                                                     \
+     .max_msgs = (q_max_msgs),                                                                     \
+     .buffer_start = (q_buffer),                                                                   \
+     .buffer_end = (q_buffer) + ((q_max_msgs) * (q_msg_size)),                                     \
+     .read_ptr = (q_buffer),                                                                       \
+     .write_ptr = (q_buffer),                                                                      \
+     .used_msgs = 0,                                                                               \
+     .flags = 0}
+#define K_MSGQ_DEFINE(q_name, q_msg_size, q_max_msgs, q_align)                                    \
+    static char __attribute__((aligned(q_align)))                                                  \
+    _k_fifo_buf_##q_name[(q_max_msgs) * (q_msg_size)];                                             \
+    STRUCT_SECTION_ITERABLE(k_msgq, q_name) =                                                      \
+        Z_MSGQ_INITIALIZER(q_name, _k_fifo_buf_##q_name, (q_msg_size), (q_max_msgs))
+
+void k_msgq_init(struct k_msgq* msgq, char* buffer, size_t msg_size, uint32_t max_msgs);
+int k_msgq_put(struct k_msgq* msgq, const void* data, k_timeout_t timeout);
+int k_msgq_get(struct k_msgq* msgq, void* data, k_timeout_t timeout);
+int k_msgq_peek(struct k_msgq* msgq, void* data);
+void k_msgq_purge(struct k_msgq* msgq);
+uint32_t k_msgq_num_free_get(struct k_msgq* msgq);
+uint32_t k_msgq_num_used_get(struct k_msgq* msgq);
+void k_msgq_get_attrs(struct k_msgq* msgq, struct k_msgq_attrs* attrs);
+
+// --- event ---
+
+struct k_event
+{
+    uint32_t events;
+};
+
+#define Z_EVENT_INITIALIZER(obj) {.events = 0}
+#define K_EVENT_DEFINE(name) STRUCT_SECTION_ITERABLE(k_event, name) = Z_EVENT_INITIALIZER(name)
+
+void k_event_init(struct k_event* event);
+/// @return the previous events
+uint32_t k_event_post(struct k_event* event, uint32_t events);
+uint32_t k_event_set(struct k_event* event, uint32_t events);
+uint32_t k_event_set_masked(struct k_event* event, uint32_t events, uint32_t events_mask);
+uint32_t k_event_clear(struct k_event* event, uint32_t events);
+uint32_t k_event_wait(struct k_event* event, uint32_t events, bool reset, k_timeout_t timeout);
+uint32_t k_event_wait_all(struct k_event* event, uint32_t events, bool reset,
+                          k_timeout_t timeout);
+/// @brief  Waits like k_event_wait(), and clears the received events.
+uint32_t k_event_wait_safe(struct k_event* event, uint32_t events, bool reset,
+                           k_timeout_t timeout);
+uint32_t k_event_wait_all_safe(struct k_event* event, uint32_t events, bool reset,
+                               k_timeout_t timeout);
+
+// --- queue, fifo and lifo ---
+
+struct k_queue
+{
+    sys_slist_t data_q;
+    unsigned int waiters;
+    unsigned int cancels;
+};
+
+#define Z_QUEUE_INITIALIZER(obj) {.data_q = SYS_SLIST_STATIC_INIT(&obj.data_q)}
+
+void k_queue_init(struct k_queue* queue);
+void k_queue_cancel_wait(struct k_queue* queue);
+void k_queue_append(struct k_queue* queue, void* data);
+void k_queue_prepend(struct k_queue* queue, void* data);
+/// @brief  Appends the NULL terminated chain of items, from head to tail.
+int k_queue_append_list(struct k_queue* queue, void* head, void* tail);
+void* k_queue_get(struct k_queue* queue, k_timeout_t timeout);
+int k_queue_is_empty(struct k_queue* queue);
+void* k_queue_peek_head(struct k_queue* queue);
+void* k_queue_peek_tail(struct k_queue* queue);
+
+struct k_fifo
+{
+    struct k_queue _queue;
+};
+
+struct k_lifo
+{
+    struct k_queue _queue;
+};
+
+#define Z_FIFO_INITIALIZER(obj) {._queue = Z_QUEUE_INITIALIZER(obj._queue)}
+#define Z_LIFO_INITIALIZER(obj) {._queue = Z_QUEUE_INITIALIZER(obj._queue)}
+#define K_FIFO_DEFINE(name) STRUCT_SECTION_ITERABLE(k_fifo, name) = Z_FIFO_INITIALIZER(name)
+#define K_LIFO_DEFINE(name) STRUCT_SECTION_ITERABLE(k_lifo, name) = Z_LIFO_INITIALIZER(name)
+
+#define k_fifo_init(fifo) k_queue_init(&(fifo)->_queue)
+#define k_fifo_cancel_wait(fifo) k_queue_cancel_wait(&(fifo)->_queue)
+#define k_fifo_put(fifo, data) k_queue_append(&(fifo)->_queue, data)
+#define k_fifo_put_list(fifo, head, tail) k_queue_append_list(&(fifo)->_queue, head, tail)
+#define k_fifo_get(fifo, timeout) k_queue_get(&(fifo)->_queue, timeout)
+#define k_fifo_is_empty(fifo) k_queue_is_empty(&(fifo)->_queue)
+#define k_fifo_peek_head(fifo) k_queue_peek_head(&(fifo)->_queue)
+#define k_fifo_peek_tail(fifo) k_queue_peek_tail(&(fifo)->_queue)
+#define k_lifo_init(lifo) k_queue_init(&(lifo)->_queue)
+#define k_lifo_put(lifo, data) k_queue_prepend(&(lifo)->_queue, data)
+#define k_lifo_get(lifo, timeout) k_queue_get(&(lifo)->_queue, timeout)
+
+// --- memory slab ---
+
+struct k_mem_slab
+{
+    char* buffer;
+    char* free_list;
+    size_t block_size;
+    uint32_t num_blocks;
+    uint32_t num_used;
+};
+
+int k_mem_slab_init(struct k_mem_slab* slab, void* buffer, size_t block_size,
+                    uint32_t num_blocks);
+int k_mem_slab_alloc(struct k_mem_slab* slab, void** mem, k_timeout_t timeout);
+void k_mem_slab_free(struct k_mem_slab* slab, void* mem);
+uint32_t k_mem_slab_num_used_get(struct k_mem_slab* slab);
+uint32_t k_mem_slab_num_free_get(struct k_mem_slab* slab);
+
+// --- heap ---
+
+/// the host heap only accounts the capacity of its buffer, the memory comes from malloc()
+struct k_heap
+{
+    size_t capacity;
+    size_t used;
+};
+
+#define K_HEAP_DEFINE(name, bytes)                                                                 \
+    struct k_heap name = {(bytes), 0}
+
+void k_heap_init(struct k_heap* heap, void* mem, size_t bytes);
+void* k_heap_alloc(struct k_heap* heap, size_t bytes, k_timeout_t timeout);
+void* k_heap_aligned_alloc(struct k_heap* heap, size_t align, size_t bytes, k_timeout_t timeout);
+void k_heap_free(struct k_heap* heap, void* mem);
+
+// --- polling ---
+
+struct k_poll_signal
+{
+    unsigned int signaled;
+    int result;
+    /// counts the raises, so that pollers notice a raise even if it's reset right away
+    unsigned int raised;
+};
+
+#define K_POLL_SIGNAL_INITIALIZER(obj) {.signaled = 0, .result = 0, .raised = 0}
+
+enum
+{
+    K_POLL_TYPE_IGNORE = 0,
+    K_POLL_TYPE_SIGNAL = BIT(0),
+    K_POLL_TYPE_SEM_AVAILABLE = BIT(1),
+    K_POLL_TYPE_DATA_AVAILABLE = BIT(2),
+    K_POLL_TYPE_FIFO_DATA_AVAILABLE = K_POLL_TYPE_DATA_AVAILABLE,
+    K_POLL_TYPE_LIFO_DATA_AVAILABLE = K_POLL_TYPE_DATA_AVAILABLE,
+    K_POLL_TYPE_MSGQ_DATA_AVAILABLE = BIT(3),
+};
+
+enum
+{
+    K_POLL_STATE_NOT_READY = 0,
+    K_POLL_STATE_SIGNALED = BIT(0),
+    K_POLL_STATE_SEM_AVAILABLE = BIT(1),
+    K_POLL_STATE_DATA_AVAILABLE = BIT(2),
+    K_POLL_STATE_FIFO_DATA_AVAILABLE = K_POLL_STATE_DATA_AVAILABLE,
+    K_POLL_STATE_LIFO_DATA_AVAILABLE = K_POLL_STATE_DATA_AVAILABLE,
+    K_POLL_STATE_MSGQ_DATA_AVAILABLE = BIT(3),
+    K_POLL_STATE_CANCELLED = BIT(4),
+};
+
+enum
+{
+    K_POLL_MODE_NOTIFY_ONLY = 0,
+};
+
+struct k_poll_event
+{
+    uint32_t tag : 8;
+    uint32_t type : 8;
+    uint32_t state : 8;
+    uint32_t mode : 1;
+    uint32_t unused : 7;
+    /// the raise count of the signal at the registration
+    unsigned int raised;
+    union
+    {
+        void* obj;
+        struct k_poll_signal* signal;
+        struct k_sem* sem;
+        struct k_fifo* fifo;
+        struct k_queue* queue;
+        struct k_msgq* msgq;
+    };
+};
+
+void k_poll_event_init(struct k_poll_event* event, uint32_t type, int mode, void* obj);
+int k_poll(struct k_poll_event* events, int num_events, k_timeout_t timeout);
+void k_poll_signal_init(struct k_poll_signal* sig);
+void k_poll_signal_reset(struct k_poll_signal* sig);
+void k_poll_signal_check(struct k_poll_signal* sig, unsigned int* signaled, int* result);
+int k_poll_signal_raise(struct k_poll_signal* sig, int result);
+
+// --- work queues ---
+
+struct k_work;
+struct k_work_q;
+typedef void (*k_work_handler_t)(struct k_work* work);
+
+enum
+{
+    K_WORK_RUNNING = BIT(0),
+    K_WORK_CANCELING = BIT(1),
+    K_WORK_QUEUED = BIT(2),
+    K_WORK_DELAYED = BIT(3),
+};
+
+struct k_work
+{
+    sys_snode_t node;
+    k_work_handler_t handler;
+    struct k_work_q* queue;
+    uint32_t flags;
+};
+
+#define Z_WORK_INITIALIZER(work_handler) {.handler = (work_handler)}
+
+struct k_work_delayable
+{
+    struct k_work work;
+    sys_snode_t timeout_node;
+    /// the uptime tick when the work is submitted, while it's delayed
+    k_ticks_t expires;
+    struct k_work_q* queue;
+};
+
+struct k_work_poll
+{
+    struct k_work work;
+    sys_snode_t poll_node;
+    struct k_work_q* workq;
+    struct k_poll_event* events;
+    int num_events;
+    /// the uptime tick when the polling times out
+    k_ticks_t expires;
+    int poll_result;
+};
+
+struct k_work_queue_config
+{
+    const char* name;
+    bool no_yield;
+    bool essential;
+};
+
+struct k_work_q
+{
+    struct k_thread thread;
+    sys_slist_t pending;
+    sys_slist_t delayed;
+    sys_slist_t polling;
+    uint32_t flags;
+};
+
+extern struct k_work_q k_sys_work_q;
+
+void k_work_init(struct k_work* work, k_work_handler_t handler);
+int k_work_busy_get(const struct k_work* work);
+static inline bool k_work_is_pending(const struct k_work* work)
+{
+    return k_work_busy_get(work) != 0;
+}
+int k_work_submit_to_queue(struct k_work_q* queue, struct k_work* work);
+int k_work_submit(struct k_work* work);
+int k_work_cancel(struct k_work* work);
+
+void k_work_queue_init(struct k_work_q* queue);
+void k_work_queue_start(struct k_work_q* queue, k_thread_stack_t* stack, size_t stack_size,
+                        int prio, const struct k_work_queue_config* cfg);
+static inline k_tid_t k_work_queue_thread_get(struct k_work_q* queue)
+{
+    return &queue->thread;
+}
+int k_work_queue_drain(struct k_work_q* queue, bool plug);
+int k_work_queue_unplug(struct k_work_q* queue);
+
+void k_work_init_delayable(struct k_work_delayable* dwork, k_work_handler_t handler);
+static inline struct k_work_delayable* k_work_delayable_from_work(struct k_work* work)
+{
+    return CONTAINER_OF(work, struct k_work_delayable, work);
+}
+int k_work_delayable_busy_get(const struct k_work_delayable* dwork);
+static inline bool k_work_delayable_is_pending(const struct k_work_delayable* dwork)
+{
+    return k_work_delayable_busy_get(dwork) != 0;
+}
+k_ticks_t k_work_delayable_expires_get(const struct k_work_delayable* dwork);
+k_ticks_t k_work_delayable_remaining_get(const struct k_work_delayable* dwork);
+int k_work_schedule_for_queue(struct k_work_q* queue, struct k_work_delayable* dwork,
+                              k_timeout_t delay);
+int k_work_schedule(struct k_work_delayable* dwork, k_timeout_t delay);
+int k_work_reschedule_for_queue(struct k_work_q* queue, struct k_work_delayable* dwork,
+                                k_timeout_t delay);
+int k_work_reschedule(struct k_work_delayable* dwork, k_timeout_t delay);
+int k_work_cancel_delayable(struct k_work_delayable* dwork);
+
+void k_work_poll_init(struct k_work_poll* work, k_work_handler_t handler);
+int k_work_poll_submit_to_queue(struct k_work_q* work_q, struct k_work_poll* work,
+                                struct k_poll_event* events, int num_events,
+                                k_timeout_t timeout);
+int k_work_poll_submit(struct k_work_poll* work, struct k_poll_event* events, int num_events,
+                       k_timeout_t timeout);
+int k_work_poll_cancel(struct k_work_poll* work);
+
+#ifdef __cplusplus
+}
+#endif
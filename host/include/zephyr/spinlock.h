@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+#include <errno.h>
+#include <sched.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/// @brief  Spinlock between host threads. Unlike on target, it doesn't lock interrupts
+///         (there are none), a thread that is preempted while holding it
+///         makes the others yield until it's rescheduled.
+struct k_spinlock
+{
+    unsigned char locked;
+};
+
+typedef struct
+{
+    int key;
+} k_spinlock_key_t;
+
+static inline k_spinlock_key_t k_spin_lock(struct k_spinlock* l)
+{
+    for (unsigned int spins = 0; __atomic_exchange_n(&l->locked, 1, __ATOMIC_ACQUIRE) != 0;)
+    {
+        while (__atomic_load_n(&l->locked, __ATOMIC_RELAXED) != 0)
+        {
+            if (++spins % 64 == 0)
+            {
+                sched_yield();
+            }
+        }
+    }
+    k_spinlock_key_t key = {0};
+    return key;
+}
+
+static inline int k_spin_trylock(struct k_spinlock* l, k_spinlock_key_t* k)
+{
+    if (__atomic_exchange_n(&l->locked, 1, __ATOMIC_ACQUIRE) != 0)
+    {
+        return -EBUSY;
+    }
+    k->key = 0;
+    return 0;
+}
+
+static inline void k_spin_unlock(struct k_spinlock* l, k_spinlock_key_t key)
+{
+    (void)key;
+    __atomic_store_n(&l->locked, 0, __ATOMIC_RELEASE);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,126 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/// @brief  Node of a circular doubly linked list, the list itself is its sentinel node.
+struct _dnode
+{
+    union
+    {
+        struct _dnode* head;
+        struct _dnode* next;
+    };
+    union
+    {
+        struct _dnode* tail;
+        struct _dnode* prev;
+    };
+};
+
+typedef struct _dnode sys_dlist_t;
+typedef struct _dnode sys_dnode_t;
+
+#define SYS_DLIST_STATIC_INIT(ptr_to_list) {{(ptr_to_list)}, {(ptr_to_list)}}
+
+static inline void sys_dlist_init(sys_dlist_t* list)
+{
+    list->head = list;
+    list->tail = list;
+}
+
+static inline void sys_dnode_init(sys_dnode_t* node)
+{
+    node->next = NULL;
+    node->prev = NULL;
+}
+
+static inline bool sys_dnode_is_linked(const sys_dnode_t* node)
+{
+    return node->next != NULL;
+}
+
+static inline bool sys_dlist_is_empty(const sys_dlist_t* list)
+{
+    return list->head == list;
+}
+
+static inline bool sys_dlist_is_head(const sys_dlist_t* list, const sys_dnode_t* node)
+{
+    return list->head == node;
+}
+
+static inline bool sys_dlist_is_tail(const sys_dlist_t* list, const sys_dnode_t* node)
+{
+    return list->tail == node;
+}
+
+static inline sys_dnode_t* sys_dlist_peek_head(const sys_dlist_t* list)
+{
+    return sys_dlist_is_empty(list) ? NULL : list->head;
+}
+
+static inline sys_dnode_t* sys_dlist_peek_tail(const sys_dlist_t* list)
+{
+    return sys_dlist_is_empty(list) ? NULL : list->tail;
+}
+
+static inline sys_dnode_t* sys_dlist_peek_next(const sys_dlist_t* list, const sys_dnode_t* node)
+{
+    return (node == NULL) || sys_dlist_is_tail(list, node) ? NULL : node->next;
+}
+
+static inline void sys_dlist_append(sys_dlist_t* list, sys_dnode_t* node)
+{
+    sys_dnode_t* const tail = list->tail;
+    node->next = list;
+    node->prev = tail;
+    tail->next = node;
+    list->tail = node;
+}
+
+static inline void sys_dlist_prepend(sys_dlist_t* list, sys_dnode_t* node)
+{
+    sys_dnode_t* const head = list->head;
+    node->next = head;
+    node->prev = list;
+    head->prev = node;
+    list->head = node;
+}
+
+/// @brief  Inserts the node before the successor node.
+static inline void sys_dlist_insert(sys_dnode_t* successor, sys_dnode_t* node)
+{
+    sys_dnode_t* const prev = successor->prev;
+    node->prev = prev;
+    node->next = successor;
+    prev->next = node;
+    successor->prev = node;
+}
+
+static inline void sys_dlist_remove(sys_dnode_t* node)
+{
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+    sys_dnode_init(node);
+}
+
+static inline sys_dnode_t* sys_dlist_get(sys_dlist_t* list)
+{
+    sys_dnode_t* node = NULL;
+    if (!sys_dlist_is_empty(list))
+    {
+        node = list->head;
+        sys_dlist_remove(node);
+    }
+    return node;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,6 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+// the host has no linker sections to iterate, the objects are plain definitions
+#define TYPE_SECTION_ITERABLE(type, varname, secname, section_postfix) type varname
+#define STRUCT_SECTION_ITERABLE(struct_type, varname) struct struct_type varname
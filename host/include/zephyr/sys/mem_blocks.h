@@ -0,0 +1,37 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+struct sys_mem_blocks_info
+{
+    uint32_t num_blocks;
+    uint8_t blk_sz_shift;
+};
+
+typedef struct sys_mem_blocks
+{
+    struct sys_mem_blocks_info info;
+    uint8_t* buffer;
+    uint32_t* bitmap;
+} sys_mem_blocks_t;
+
+#define SYS_MEM_BLOCKS_DEFINE(name, blk_sz, num_blks, buf_align)                                   \
+    static uint8_t _mem_blocks_buf_##name[(blk_sz) * (num_blks)]                                   \
+        __attribute__((aligned(buf_align)));                                                       \
+    static uint32_t _mem_blocks_bitmap_##name[((num_blks) + 31) / 32];                             \
+    sys_mem_blocks_t name = {{(num_blks), (uint8_t)__builtin_ctz(blk_sz)},                         \
+                             _mem_blocks_buf_##name,                                               \
+                             _mem_blocks_bitmap_##name}
+
+int sys_mem_blocks_alloc_contiguous(sys_mem_blocks_t* mem_block, size_t count, void** out_block);
+int sys_mem_blocks_free_contiguous(sys_mem_blocks_t* mem_block, void* block, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
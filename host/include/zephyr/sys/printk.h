@@ -0,0 +1,23 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+#include <stdarg.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+__attribute__((format(printf, 1, 2))) static inline void printk(const char* fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    vprintf(fmt, args);
+    va_end(args);
+    // printk() output is synchronous on target too
+    fflush(stdout);
+}
+
+#ifdef __cplusplus
+}
+#endif
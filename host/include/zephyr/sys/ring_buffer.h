@@ -0,0 +1,135 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/// @brief  Byte ring buffer, the positions are free running and wrap at the buffer size.
+struct ring_buf
+{
+    uint8_t* buffer;
+    uint32_t size;
+    uint32_t put_head;
+    uint32_t put_tail;
+    uint32_t get_head;
+    uint32_t get_tail;
+};
+
+static inline void ring_buf_init(struct ring_buf* buf, uint32_t size, uint8_t* data)
+{
+    buf->buffer = data;
+    buf->size = size;
+    buf->put_head = buf->put_tail = buf->get_head = buf->get_tail = 0;
+}
+
+static inline void ring_buf_reset(struct ring_buf* buf)
+{
+    buf->put_head = buf->put_tail = buf->get_head = buf->get_tail = 0;
+}
+
+static inline uint32_t ring_buf_capacity_get(const struct ring_buf* buf)
+{
+    return buf->size;
+}
+
+static inline uint32_t ring_buf_size_get(const struct ring_buf* buf)
+{
+    return buf->put_tail - buf->get_head;
+}
+
+static inline uint32_t ring_buf_space_get(const struct ring_buf* buf)
+{
+    return buf->size - (buf->put_head - buf->get_tail);
+}
+
+static inline bool ring_buf_is_empty(const struct ring_buf* buf)
+{
+    return buf->get_head == buf->put_tail;
+}
+
+/// @brief  The contiguous part of the region at the position, up to size bytes.
+static inline uint32_t ring_buf_region(const struct ring_buf* buf, uint32_t position,
+                                       uint32_t available, uint32_t size, uint8_t** data)
+{
+    const uint32_t offset = position % buf->size;
+    uint32_t n = buf->size - offset;
+    n = n < available ? n : available;
+    *data = &buf->buffer[offset];
+    return n < size ? n : size;
+}
+
+static inline uint32_t ring_buf_put_claim(struct ring_buf* buf, uint8_t** data, uint32_t size)
+{
+    const uint32_t n = ring_buf_region(buf, buf->put_head, ring_buf_space_get(buf), size, data);
+    buf->put_head += n;
+    return n;
+}
+
+static inline int ring_buf_put_finish(struct ring_buf* buf, uint32_t size)
+{
+    if (size > buf->put_head - buf->put_tail)
+    {
+        buf->put_head = buf->put_tail;
+        return -EINVAL;
+    }
+    buf->put_tail += size;
+    buf->put_head = buf->put_tail;
+    return 0;
+}
+
+static inline uint32_t ring_buf_get_claim(struct ring_buf* buf, uint8_t** data, uint32_t size)
+{
+    const uint32_t n =
+        ring_buf_region(buf, buf->get_head, buf->put_tail - buf->get_head, size, data);
+    buf->get_head += n;
+    return n;
+}
+
+static inline int ring_buf_get_finish(struct ring_buf* buf, uint32_t size)
+{
+    if (size > buf->get_head - buf->get_tail)
+    {
+        buf->get_head = buf->get_tail;
+        return -EINVAL;
+    }
+    buf->get_tail += size;
+    buf->get_head = buf->get_tail;
+    return 0;
+}
+
+static inline uint32_t ring_buf_put(struct ring_buf* buf, const uint8_t* data, uint32_t size)
+{
+    uint32_t total = 0;
+    uint8_t* region;
+    for (uint32_t n; (n = ring_buf_put_claim(buf, &region, size - total)) > 0; total += n)
+    {
+        memcpy(region, data + total, n);
+    }
+    ring_buf_put_finish(buf, total);
+    return total;
+}
+
+static inline uint32_t ring_buf_get(struct ring_buf* buf, uint8_t* data, uint32_t size)
+{
+    uint32_t total = 0;
+    uint8_t* region;
+    for (uint32_t n; (n = ring_buf_get_claim(buf, &region, size - total)) > 0; total += n)
+    {
+        if (data != NULL)
+        {
+            memcpy(data + total, region, n);
+        }
+    }
+    ring_buf_get_finish(buf, total);
+    return total;
+}
+
+#ifdef __cplusplus
+}
+#endif
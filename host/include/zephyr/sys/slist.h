@@ -0,0 +1,146 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef struct _snode
+{
+    struct _snode* next;
+} sys_snode_t;
+
+typedef struct _slist
+{
+    sys_snode_t* head;
+    sys_snode_t* tail;
+} sys_slist_t;
+
+#define SYS_SLIST_STATIC_INIT(ptr_to_list) {NULL, NULL}
+
+#define SYS_SLIST_FOR_EACH_NODE(list, sn) for (sn = (list)->head; sn != NULL; sn = sn->next)
+
+#define SYS_SLIST_FOR_EACH_NODE_SAFE(list, sn, sns)                                                \
+    for (sn = (list)->head, sns = (sn != NULL) ? sn->next : NULL; sn != NULL;                      \
+         sn = sns, sns = (sn != NULL) ? sn->next : NULL)
+
+static inline void sys_slist_init(sys_slist_t* list)
+{
+    list->head = NULL;
+    list->tail = NULL;
+}
+
+static inline bool sys_slist_is_empty(const sys_slist_t* list)
+{
+    return list->head == NULL;
+}
+
+static inline sys_snode_t* sys_slist_peek_head(const sys_slist_t* list)
+{
+    return list->head;
+}
+
+static inline sys_snode_t* sys_slist_peek_tail(const sys_slist_t* list)
+{
+    return list->tail;
+}
+
+static inline sys_snode_t* sys_slist_peek_next(const sys_snode_t* node)
+{
+    return node != NULL ? node->next : NULL;
+}
+
+static inline void sys_slist_prepend(sys_slist_t* list, sys_snode_t* node)
+{
+    node->next = list->head;
+    list->head = node;
+    if (list->tail == NULL)
+    {
+        list->tail = node;
+    }
+}
+
+static inline void sys_slist_append(sys_slist_t* list, sys_snode_t* node)
+{
+    node->next = NULL;
+    if (list->tail == NULL)
+    {
+        list->head = node;
+    }
+    else
+    {
+        list->tail->next = node;
+    }
+    list->tail = node;
+}
+
+/// @brief  Appends a NULL terminated chain of nodes, from head to tail.
+static inline void sys_slist_append_list(sys_slist_t* list, void* head, void* tail)
+{
+    if (list->tail == NULL)
+    {
+        list->head = (sys_snode_t*)head;
+    }
+    else
+    {
+        list->tail->next = (sys_snode_t*)head;
+    }
+    list->tail = (sys_snode_t*)tail;
+}
+
+static inline sys_snode_t* sys_slist_get_not_empty(sys_slist_t* list)
+{
+    sys_snode_t* node = list->head;
+    list->head = node->next;
+    if (list->tail == node)
+    {
+        list->tail = NULL;
+    }
+    return node;
+}
+
+static inline sys_snode_t* sys_slist_get(sys_slist_t* list)
+{
+    return sys_slist_is_empty(list) ? NULL : sys_slist_get_not_empty(list);
+}
+
+/// @brief  Removes the node, that follows prev_node (or is the head, if prev_node is NULL).
+static inline void sys_slist_remove(sys_slist_t* list, sys_snode_t* prev_node, sys_snode_t* node)
+{
+    if (prev_node == NULL)
+    {
+        list->head = node->next;
+    }
+    else
+    {
+        prev_node->next = node->next;
+    }
+    if (list->tail == node)
+    {
+        list->tail = prev_node;
+    }
+    node->next = NULL;
+}
+
+static inline bool sys_slist_find_and_remove(sys_slist_t* list, sys_snode_t* node)
+{
+    sys_snode_t* prev = NULL;
+    sys_snode_t* test;
+    SYS_SLIST_FOR_EACH_NODE(list, test)
+    {
+        if (test == node)
+        {
+            sys_slist_remove(list, prev, node);
+            return true;
+        }
+        prev = test;
+    }
+    return false;
+}
+
+#ifdef __cplusplus
+}
+#endif
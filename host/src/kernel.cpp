@@ -0,0 +1,936 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <span>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <zephyr/sys/mem_blocks.h>
+#include "kernel_lock.hpp"
+
+namespace zephyr::host
+{
+namespace
+{
+#ifdef PTHREAD_ADAPTIVE_MUTEX_INITIALIZER_NP
+pthread_mutex_t kernel_mutex = PTHREAD_ADAPTIVE_MUTEX_INITIALIZER_NP;
+#else
+pthread_mutex_t kernel_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+/// bumped by every notification, the futex word that the waiting threads block on
+std::atomic<std::uint32_t> epoch{};
+static_assert(sizeof(epoch) == sizeof(std::uint32_t));
+/// the number of threads blocked on epoch, protected by kernel_mutex
+unsigned int waiters{};
+
+pthread_mutex_t irq_mutex = PTHREAD_MUTEX_INITIALIZER;
+thread_local unsigned int irq_depth{};
+
+std::int64_t monotonic_ns()
+{
+    timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<std::int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+/// @brief  The monotonic time of the process start, the epoch of the uptime.
+std::int64_t start_ns()
+{
+    static const std::int64_t start = monotonic_ns();
+    return start;
+}
+
+long futex(std::atomic<std::uint32_t>& word, int op, std::uint32_t value, const timespec* abs_time)
+{
+    return ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), op, value, abs_time,
+                     nullptr, FUTEX_BITSET_MATCH_ANY);
+}
+} // namespace
+
+std::int64_t now_ns()
+{
+    // the epoch is latched first, so that the first uptime isn't negative
+    const std::int64_t start = start_ns();
+    return monotonic_ns() - start;
+}
+
+std::int64_t to_deadline(k_timeout_t timeout)
+{
+    if (timeout.ticks == K_TICKS_FOREVER)
+    {
+        return forever;
+    }
+    if (timeout.ticks < 0)
+    {
+        return ticks_to_ns(Z_TICK_ABS(timeout.ticks));
+    }
+    if (timeout.ticks == 0)
+    {
+        return 0;
+    }
+    const std::int64_t now = now_ns();
+    return timeout.ticks < (forever - now) / ticks_to_ns(1) ? now + ticks_to_ns(timeout.ticks)
+                                                            : forever;
+}
+
+::timespec to_timespec(std::int64_t deadline)
+{
+    const std::int64_t t = start_ns() + deadline;
+    return {static_cast<time_t>(t / 1000000000), static_cast<long>(t % 1000000000)};
+}
+
+kernel_lock::kernel_lock()
+{
+    acquire();
+}
+
+kernel_lock::~kernel_lock()
+{
+    release();
+}
+
+void kernel_lock::release()
+{
+    ::pthread_mutex_unlock(&kernel_mutex);
+}
+
+void kernel_lock::acquire()
+{
+    ::pthread_mutex_lock(&kernel_mutex);
+}
+
+void kernel_lock::notify_all()
+{
+    epoch.fetch_add(1, std::memory_order_relaxed);
+    if (waiters > 0)
+    {
+        futex(epoch, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr);
+    }
+}
+
+bool kernel_lock::wait(std::int64_t deadline)
+{
+    timespec abs_time{};
+    if (deadline != forever)
+    {
+        if (deadline <= now_ns())
+        {
+            return false;
+        }
+        abs_time = to_timespec(deadline);
+    }
+    // the futex only blocks if no notification arrived since the epoch was read
+    const std::uint32_t seq = epoch.load(std::memory_order_relaxed);
+    ++waiters;
+    release();
+    const unsigned int depth = irq_release();
+    futex(epoch, FUTEX_WAIT_BITSET_PRIVATE, seq, deadline != forever ? &abs_time : nullptr);
+    irq_restore(depth);
+    acquire();
+    --waiters;
+    return true;
+}
+
+unsigned int irq_release()
+{
+    const unsigned int depth = irq_depth;
+    if (depth > 0)
+    {
+        irq_depth = 0;
+        ::pthread_mutex_unlock(&irq_mutex);
+    }
+    return depth;
+}
+
+void irq_restore(unsigned int depth)
+{
+    if (depth > 0)
+    {
+        ::pthread_mutex_lock(&irq_mutex);
+        irq_depth = depth;
+    }
+}
+
+void poll_register(::k_poll_event* events, int num_events)
+{
+    for (auto& e : std::span(events, static_cast<std::size_t>(num_events)))
+    {
+        if (e.type == K_POLL_TYPE_SIGNAL)
+        {
+            e.raised = e.signal->raised;
+        }
+    }
+}
+
+int poll_states(::k_poll_event* events, int num_events)
+{
+    int ready = 0;
+    for (auto& e : std::span(events, static_cast<std::size_t>(num_events)))
+    {
+        std::uint32_t state = K_POLL_STATE_NOT_READY;
+        switch (e.type)
+        {
+        case K_POLL_TYPE_SIGNAL:
+            if ((e.signal->signaled != 0) or (e.signal->raised != e.raised))
+            {
+                state = K_POLL_STATE_SIGNALED;
+            }
+            break;
+        case K_POLL_TYPE_SEM_AVAILABLE:
+            if (e.sem->count > 0)
+            {
+                state = K_POLL_STATE_SEM_AVAILABLE;
+            }
+            break;
+        case K_POLL_TYPE_DATA_AVAILABLE:
+            if (!sys_slist_is_empty(&e.queue->data_q))
+            {
+                state = K_POLL_STATE_DATA_AVAILABLE;
+            }
+            break;
+        case K_POLL_TYPE_MSGQ_DATA_AVAILABLE:
+            if (e.msgq->used_msgs > 0)
+            {
+                state = K_POLL_STATE_MSGQ_DATA_AVAILABLE;
+            }
+            break;
+        default:
+            break;
+        }
+        if (state != K_POLL_STATE_NOT_READY)
+        {
+            e.state |= state;
+            ++ready;
+        }
+    }
+    return ready;
+}
+
+} // namespace zephyr::host
+
+using namespace zephyr::host;
+
+namespace
+{
+/// @brief  The error code of a failed wait, when the object isn't available.
+int unavailable(k_timeout_t timeout, int no_wait_error)
+{
+    return K_TIMEOUT_EQ(timeout, K_NO_WAIT) ? no_wait_error : -EAGAIN;
+}
+
+void mutex_release(::k_mutex* mutex, kernel_lock& lock)
+{
+    if (--mutex->lock_count == 0)
+    {
+        mutex->owner = nullptr;
+        lock.notify_all();
+    }
+}
+
+void mutex_acquire(::k_mutex* mutex, ::k_thread* self)
+{
+    mutex->owner = self;
+    mutex->lock_count = 1;
+}
+
+std::uint32_t event_wait(::k_event* event, std::uint32_t events, bool reset, k_timeout_t timeout,
+                         bool all, bool safe)
+{
+    kernel_lock lock;
+    if (reset)
+    {
+        event->events = 0;
+    }
+    std::uint32_t matched = 0;
+    const bool received = lock.wait_until(timeout, [&] {
+        matched = event->events & events;
+        return all ? (matched == events) : (matched != 0);
+    });
+    if (!received)
+    {
+        return 0;
+    }
+    if (safe)
+    {
+        event->events &= ~matched;
+    }
+    return matched;
+}
+
+char* msgq_advance(::k_msgq* msgq, char* ptr)
+{
+    ptr += msgq->msg_size;
+    return ptr == msgq->buffer_end ? msgq->buffer_start : ptr;
+}
+} // namespace
+
+/// @brief  A thread blocked in k_sem_take, on the stack of that thread.
+struct z_sem_waiter
+{
+    z_sem_waiter* next;
+    bool given;
+};
+
+extern "C"
+{
+k_ticks_t k_uptime_ticks(void)
+{
+    return now_ns() / ticks_to_ns(1);
+}
+
+int64_t k_uptime_get(void)
+{
+    return now_ns() / 1000000;
+}
+
+uint32_t k_uptime_get_32(void)
+{
+    return static_cast<uint32_t>(k_uptime_get());
+}
+
+uint32_t k_cycle_get_32(void)
+{
+    return static_cast<uint32_t>(now_ns());
+}
+
+uint64_t k_cycle_get_64(void)
+{
+    return static_cast<uint64_t>(now_ns());
+}
+
+unsigned int irq_lock(void)
+{
+    if (irq_depth == 0)
+    {
+        ::pthread_mutex_lock(&irq_mutex);
+    }
+    return irq_depth++;
+}
+
+void irq_unlock(unsigned int key)
+{
+    irq_depth = key;
+    if (key == 0)
+    {
+        ::pthread_mutex_unlock(&irq_mutex);
+    }
+}
+
+int k_sem_init(struct k_sem* sem, unsigned int initial_count, unsigned int limit)
+{
+    if ((limit == 0) or (initial_count > limit))
+    {
+        return -EINVAL;
+    }
+    kernel_lock lock;
+    sem->count = initial_count;
+    sem->limit = limit;
+    sem->first_waiter = nullptr;
+    sem->last_waiter = nullptr;
+    return 0;
+}
+
+int k_sem_take(struct k_sem* sem, k_timeout_t timeout)
+{
+    kernel_lock lock;
+    if (sem->count > 0)
+    {
+        --sem->count;
+        return 0;
+    }
+    z_sem_waiter self{};
+    (sem->last_waiter != nullptr ? sem->last_waiter->next : sem->first_waiter) = &self;
+    sem->last_waiter = &self;
+    if (!lock.wait_until(timeout, [&self] { return self.given; }))
+    {
+        // leave the queue, a later give goes to the next waiter
+        z_sem_waiter* previous = nullptr;
+        for (auto* w = sem->first_waiter; w != &self; previous = w, w = w->next)
+        {
+        }
+        (previous != nullptr ? previous->next : sem->first_waiter) = self.next;
+        if (sem->last_waiter == &self)
+        {
+            sem->last_waiter = previous;
+        }
+        return unavailable(timeout, -EBUSY);
+    }
+    return 0;
+}
+
+void k_sem_give(struct k_sem* sem)
+{
+    kernel_lock lock;
+    // like the kernel, a give is handed to the first waiting thread, instead of the count
+    if (z_sem_waiter* const waiter = sem->first_waiter; waiter != nullptr)
+    {
+        sem->first_waiter = waiter->next;
+        if (sem->first_waiter == nullptr)
+        {
+            sem->last_waiter = nullptr;
+        }
+        waiter->given = true;
+        lock.notify_all();
+        return;
+    }
+    if (sem->count < sem->limit)
+    {
+        ++sem->count;
+    }
+    lock.notify_all();
+}
+
+void k_sem_reset(struct k_sem* sem)
+{
+    kernel_lock lock;
+    sem->count = 0;
+}
+
+unsigned int k_sem_count_get(struct k_sem* sem)
+{
+    kernel_lock lock;
+    return sem->count;
+}
+
+int k_mutex_init(struct k_mutex* mutex)
+{
+    kernel_lock lock;
+    mutex->owner = nullptr;
+    mutex->lock_count = 0;
+    return 0;
+}
+
+int k_mutex_lock(struct k_mutex* mutex, k_timeout_t timeout)
+{
+    ::k_thread* const self = k_current_get();
+    kernel_lock lock;
+    if (mutex->owner == self)
+    {
+        ++mutex->lock_count;
+        return 0;
+    }
+    if (!lock.wait_until(timeout, [mutex] { return mutex->owner == nullptr; }))
+    {
+        return unavailable(timeout, -EBUSY);
+    }
+    mutex_acquire(mutex, self);
+    return 0;
+}
+
+int k_mutex_unlock(struct k_mutex* mutex)
+{
+    ::k_thread* const self = k_current_get();
+    kernel_lock lock;
+    if (mutex->owner == nullptr)
+    {
+        return -EINVAL;
+    }
+    if (mutex->owner != self)
+    {
+        return -EPERM;
+    }
+    mutex_release(mutex, lock);
+    return 0;
+}
+
+int k_condvar_init(struct k_condvar* condvar)
+{
+    kernel_lock lock;
+    condvar->waiters = 0;
+    condvar->wakeups = 0;
+    return 0;
+}
+
+int k_condvar_signal(struct k_condvar* condvar)
+{
+    kernel_lock lock;
+    if (condvar->wakeups < condvar->waiters)
+    {
+        ++condvar->wakeups;
+        lock.notify_all();
+    }
+    return 0;
+}
+
+int k_condvar_broadcast(struct k_condvar* condvar)
+{
+    kernel_lock lock;
+    const unsigned int woken = condvar->waiters - condvar->wakeups;
+    condvar->wakeups = condvar->waiters;
+    lock.notify_all();
+    return static_cast<int>(woken);
+}
+
+int k_condvar_wait(struct k_condvar* condvar, struct k_mutex* mutex, k_timeout_t timeout)
+{
+    ::k_thread* const self = k_current_get();
+    kernel_lock lock;
+    __ASSERT_NO_MSG(mutex->owner == self);
+    mutex_release(mutex, lock);
+
+    ++condvar->waiters;
+    const bool woken = lock.wait_until(timeout, [condvar] { return condvar->wakeups > 0; });
+    --condvar->waiters;
+    if (woken)
+    {
+        --condvar->wakeups;
+    }
+
+    lock.wait_until(K_FOREVER, [mutex] { return mutex->owner == nullptr; });
+    mutex_acquire(mutex, self);
+    return woken ? 0 : -EAGAIN;
+}
+
+int k_futex_wait(struct k_futex* futex, int expected, k_timeout_t timeout)
+{
+    kernel_lock lock;
+    if (atomic_get(&futex->val) != expected)
+    {
+        return -EAGAIN;
+    }
+    ++futex->waiters;
+    const bool woken = lock.wait_until(timeout, [futex] { return futex->wakeups > 0; });
+    --futex->waiters;
+    if (!woken)
+    {
+        return -ETIMEDOUT;
+    }
+    --futex->wakeups;
+    return 0;
+}
+
+int k_futex_wake(struct k_futex* futex, bool wake_all)
+{
+    kernel_lock lock;
+    const unsigned int sleeping = futex->waiters - futex->wakeups;
+    const unsigned int woken = wake_all ? sleeping : std::min(sleeping, 1U);
+    if (woken > 0)
+    {
+        futex->wakeups += woken;
+        lock.notify_all();
+    }
+    return static_cast<int>(woken);
+}
+
+void k_msgq_init(struct k_msgq* msgq, char* buffer, size_t msg_size, uint32_t max_msgs)
+{
+    kernel_lock lock;
+    *msgq = Z_MSGQ_INITIALIZER(*msgq, buffer, msg_size, max_msgs);
+}
+
+int k_msgq_put(struct k_msgq* msgq, const void* data, k_timeout_t timeout)
+{
+    kernel_lock lock;
+    if (!lock.wait_until(timeout, [msgq] { return msgq->used_msgs < msgq->max_msgs; }))
+    {
+        return unavailable(timeout, -ENOMSG);
+    }
+    std::memcpy(msgq->write_ptr, data, msgq->msg_size);
+    msgq->write_ptr = msgq_advance(msgq, msgq->write_ptr);
+    ++msgq->used_msgs;
+    lock.notify_all();
+    return 0;
+}
+
+int k_msgq_get(struct k_msgq* msgq, void* data, k_timeout_t timeout)
+{
+    kernel_lock lock;
+    if (!lock.wait_until(timeout, [msgq] { return msgq->used_msgs > 0; }))
+    {
+        return unavailable(timeout, -ENOMSG);
+    }
+    std::memcpy(data, msgq->read_ptr, msgq->msg_size);
+    msgq->read_ptr = msgq_advance(msgq, msgq->read_ptr);
+    --msgq->used_msgs;
+    lock.notify_all();
+    return 0;
+}
+
+int k_msgq_peek(struct k_msgq* msgq, void* data)
+{
+    kernel_lock lock;
+    if (msgq->used_msgs == 0)
+    {
+        return -ENOMSG;
+    }
+    std::memcpy(data, msgq->read_ptr, msgq->msg_size);
+    return 0;
+}
+
+void k_msgq_purge(struct k_msgq* msgq)
+{
+    kernel_lock lock;
+    msgq->read_ptr = msgq->write_ptr;
+    msgq->used_msgs = 0;
+    lock.notify_all();
+}
+
+uint32_t k_msgq_num_free_get(struct k_msgq* msgq)
+{
+    kernel_lock lock;
+    return msgq->max_msgs - msgq->used_msgs;
+}
+
+uint32_t k_msgq_num_used_get(struct k_msgq* msgq)
+{
+    kernel_lock lock;
+    return msgq->used_msgs;
+}
+
+void k_msgq_get_attrs(struct k_msgq* msgq, struct k_msgq_attrs* attrs)
+{
+    kernel_lock lock;
+    attrs->msg_size = msgq->msg_size;
+    attrs->max_msgs = msgq->max_msgs;
+    attrs->used_msgs = msgq->used_msgs;
+}
+
+void k_event_init(struct k_event* event)
+{
+    kernel_lock lock;
+    event->events = 0;
+}
+
+uint32_t k_event_post(struct k_event* event, uint32_t events)
+{
+    return k_event_set_masked(event, events, events);
+}
+
+uint32_t k_event_set(struct k_event* event, uint32_t events)
+{
+    return k_event_set_masked(event, events, UINT32_MAX);
+}
+
+uint32_t k_event_set_masked(struct k_event* event, uint32_t events, uint32_t events_mask)
+{
+    kernel_lock lock;
+    const uint32_t previous = event->events;
+    event->events = (previous & ~events_mask) | (events & events_mask);
+    lock.notify_all();
+    return previous;
+}
+
+uint32_t k_event_clear(struct k_event* event, uint32_t events)
+{
+    kernel_lock lock;
+    const uint32_t previous = event->events;
+    event->events = previous & ~events;
+    return previous;
+}
+
+uint32_t k_event_wait(struct k_event* event, uint32_t events, bool reset, k_timeout_t timeout)
+{
+    return event_wait(event, events, reset, timeout, false, false);
+}
+
+uint32_t k_event_wait_all(struct k_event* event, uint32_t events, bool reset, k_timeout_t timeout)
+{
+    return event_wait(event, events, reset, timeout, true, false);
+}
+
+uint32_t k_event_wait_safe(struct k_event* event, uint32_t events, bool reset,
+                           k_timeout_t timeout)
+{
+    return event_wait(event, events, reset, timeout, false, true);
+}
+
+uint32_t k_event_wait_all_safe(struct k_event* event, uint32_t events, bool reset,
+                               k_timeout_t timeout)
+{
+    return event_wait(event, events, reset, timeout, true, true);
+}
+
+void k_queue_init(struct k_queue* queue)
+{
+    kernel_lock lock;
+    sys_slist_init(&queue->data_q);
+    queue->waiters = 0;
+    queue->cancels = 0;
+}
+
+void k_queue_cancel_wait(struct k_queue* queue)
+{
+    kernel_lock lock;
+    if (queue->cancels < queue->waiters)
+    {
+        ++queue->cancels;
+        lock.notify_all();
+    }
+}
+
+void k_queue_append(struct k_queue* queue, void* data)
+{
+    kernel_lock lock;
+    sys_slist_append(&queue->data_q, static_cast<sys_snode_t*>(data));
+    lock.notify_all();
+}
+
+void k_queue_prepend(struct k_queue* queue, void* data)
+{
+    kernel_lock lock;
+    sys_slist_prepend(&queue->data_q, static_cast<sys_snode_t*>(data));
+    lock.notify_all();
+}
+
+int k_queue_append_list(struct k_queue* queue, void* head, void* tail)
+{
+    if ((head == nullptr) or (tail == nullptr))
+    {
+        return -EINVAL;
+    }
+    kernel_lock lock;
+    sys_slist_append_list(&queue->data_q, head, tail);
+    lock.notify_all();
+    return 0;
+}
+
+void* k_queue_get(struct k_queue* queue, k_timeout_t timeout)
+{
+    kernel_lock lock;
+    ++queue->waiters;
+    lock.wait_until(timeout, [queue] {
+        return !sys_slist_is_empty(&queue->data_q) or (queue->cancels > 0);
+    });
+    --queue->waiters;
+    if (!sys_slist_is_empty(&queue->data_q))
+    {
+        queue->cancels = std::min(queue->cancels, queue->waiters);
+        return sys_slist_get_not_empty(&queue->data_q);
+    }
+    if (queue->cancels > 0)
+    {
+        --queue->cancels;
+    }
+    return nullptr;
+}
+
+int k_queue_is_empty(struct k_queue* queue)
+{
+    kernel_lock lock;
+    return sys_slist_is_empty(&queue->data_q);
+}
+
+void* k_queue_peek_head(struct k_queue* queue)
+{
+    kernel_lock lock;
+    return sys_slist_peek_head(&queue->data_q);
+}
+
+void* k_queue_peek_tail(struct k_queue* queue)
+{
+    kernel_lock lock;
+    return sys_slist_peek_tail(&queue->data_q);
+}
+
+int k_mem_slab_init(struct k_mem_slab* slab, void* buffer, size_t block_size, uint32_t num_blocks)
+{
+    if ((block_size < sizeof(void*)) or (block_size % alignof(void*) != 0) or
+        (reinterpret_cast<std::uintptr_t>(buffer) % alignof(void*) != 0))
+    {
+        return -EINVAL;
+    }
+    kernel_lock lock;
+    slab->buffer = static_cast<char*>(buffer);
+    slab->block_size = block_size;
+    slab->num_blocks = num_blocks;
+    slab->num_used = 0;
+    slab->free_list = nullptr;
+    for (uint32_t i = num_blocks; i > 0; --i)
+    {
+        char* const block = slab->buffer + (i - 1) * block_size;
+        *reinterpret_cast<char**>(block) = slab->free_list;
+        slab->free_list = block;
+    }
+    return 0;
+}
+
+int k_mem_slab_alloc(struct k_mem_slab* slab, void** mem, k_timeout_t timeout)
+{
+    kernel_lock lock;
+    if (!lock.wait_until(timeout, [slab] { return slab->free_list != nullptr; }))
+    {
+        *mem = nullptr;
+        return unavailable(timeout, -ENOMEM);
+    }
+    *mem = slab->free_list;
+    slab->free_list = *reinterpret_cast<char**>(slab->free_list);
+    ++slab->num_used;
+    return 0;
+}
+
+void k_mem_slab_free(struct k_mem_slab* slab, void* mem)
+{
+    kernel_lock lock;
+    *static_cast<char**>(mem) = slab->free_list;
+    slab->free_list = static_cast<char*>(mem);
+    --slab->num_used;
+    lock.notify_all();
+}
+
+uint32_t k_mem_slab_num_used_get(struct k_mem_slab* slab)
+{
+    kernel_lock lock;
+    return slab->num_used;
+}
+
+uint32_t k_mem_slab_num_free_get(struct k_mem_slab* slab)
+{
+    kernel_lock lock;
+    return slab->num_blocks - slab->num_used;
+}
+
+void k_heap_init(struct k_heap* heap, void* mem, size_t bytes)
+{
+    ARG_UNUSED(mem);
+    heap->capacity = bytes;
+    heap->used = 0;
+}
+
+void* k_heap_alloc(struct k_heap* heap, size_t bytes, k_timeout_t timeout)
+{
+    return k_heap_aligned_alloc(heap, sizeof(void*), bytes, timeout);
+}
+
+void* k_heap_aligned_alloc(struct k_heap* heap, size_t align, size_t bytes, k_timeout_t timeout)
+{
+    // the allocation is preceded by its offset from the host block and its accounted size
+    const size_t offset = std::max(align, 2 * sizeof(size_t));
+    if ((bytes == 0) or (bytes > heap->capacity))
+    {
+        return nullptr;
+    }
+    {
+        kernel_lock lock;
+        if (!lock.wait_until(timeout, [=] { return heap->used + bytes <= heap->capacity; }))
+        {
+            return nullptr;
+        }
+        heap->used += bytes;
+    }
+    auto* const block = static_cast<char*>(
+        std::aligned_alloc(offset, (offset + bytes + offset - 1) / offset * offset));
+    if (block == nullptr)
+    {
+        kernel_lock lock;
+        heap->used -= bytes;
+        lock.notify_all();
+        return nullptr;
+    }
+    auto* const header = reinterpret_cast<size_t*>(block + offset) - 2;
+    header[0] = offset;
+    header[1] = bytes;
+    return block + offset;
+}
+
+void k_heap_free(struct k_heap* heap, void* mem)
+{
+    if (mem == nullptr)
+    {
+        return;
+    }
+    const auto* const header = static_cast<const size_t*>(mem) - 2;
+    {
+        kernel_lock lock;
+        heap->used -= header[1];
+        lock.notify_all();
+    }
+    std::free(static_cast<char*>(mem) - header[0]);
+}
+
+int sys_mem_blocks_alloc_contiguous(sys_mem_blocks_t* mem_block, size_t count, void** out_block)
+{
+    const auto is_free = [mem_block](uint32_t i) {
+        return (mem_block->bitmap[i / 32] & BIT(i % 32)) == 0;
+    };
+    kernel_lock lock;
+    for (uint32_t first = 0, end = 0; end < mem_block->info.num_blocks; ++end)
+    {
+        if (!is_free(end))
+        {
+            first = end + 1;
+        }
+        else if (end + 1 - first == count)
+        {
+            for (uint32_t i = first; i <= end; ++i)
+            {
+                mem_block->bitmap[i / 32] |= BIT(i % 32);
+            }
+            *out_block = mem_block->buffer + (size_t{first} << mem_block->info.blk_sz_shift);
+            return 0;
+        }
+    }
+    *out_block = nullptr;
+    return -ENOMEM;
+}
+
+int sys_mem_blocks_free_contiguous(sys_mem_blocks_t* mem_block, void* block, size_t count)
+{
+    const auto first = static_cast<uint32_t>((static_cast<uint8_t*>(block) - mem_block->buffer) >>
+                                             mem_block->info.blk_sz_shift);
+    if (first + count > mem_block->info.num_blocks)
+    {
+        return -EFAULT;
+    }
+    kernel_lock lock;
+    for (uint32_t i = first; i < first + count; ++i)
+    {
+        mem_block->bitmap[i / 32] &= ~BIT(i % 32);
+    }
+    return 0;
+}
+
+void k_poll_event_init(struct k_poll_event* event, uint32_t type, int mode, void* obj)
+{
+    event->type = type;
+    event->state = K_POLL_STATE_NOT_READY;
+    event->mode = static_cast<uint32_t>(mode);
+    event->unused = 0;
+    event->raised = 0;
+    event->obj = obj;
+}
+
+int k_poll(struct k_poll_event* events, int num_events, k_timeout_t timeout)
+{
+    kernel_lock lock;
+    poll_register(events, num_events);
+    if (!lock.wait_until(timeout, [=] { return poll_states(events, num_events) > 0; }))
+    {
+        return -EAGAIN;
+    }
+    return 0;
+}
+
+void k_poll_signal_init(struct k_poll_signal* sig)
+{
+    kernel_lock lock;
+    sig->signaled = 0;
+    sig->result = 0;
+}
+
+void k_poll_signal_reset(struct k_poll_signal* sig)
+{
+    kernel_lock lock;
+    sig->signaled = 0;
+}
+
+void k_poll_signal_check(struct k_poll_signal* sig, unsigned int* signaled, int* result)
+{
+    kernel_lock lock;
+    *signaled = sig->signaled;
+    *result = sig->result;
+}
+
+int k_poll_signal_raise(struct k_poll_signal* sig, int result)
+{
+    kernel_lock lock;
+    sig->result = result;
+    sig->signaled = 1;
+    ++sig->raised;
+    lock.notify_all();
+    return 0;
+}
+} // extern "C"
@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+#include <cstdint>
+#include <ctime>
+#include <limits>
+#include <zephyr/kernel.h>
+
+namespace zephyr::host
+{
+/// @brief  The deadline of the waits that never time out.
+inline constexpr std::int64_t forever = std::numeric_limits<std::int64_t>::max();
+
+/// @brief  The monotonic time since the process start, in nanoseconds.
+std::int64_t now_ns();
+
+/// @brief  Converts a kernel timeout to an absolute deadline, in nanoseconds since the start.
+std::int64_t to_deadline(k_timeout_t timeout);
+
+/// @brief  Converts an absolute deadline to a CLOCK_MONOTONIC time, for the host's timed calls.
+::timespec to_timespec(std::int64_t deadline);
+
+inline std::int64_t ticks_to_ns(k_ticks_t ticks)
+{
+    return ticks * (1000000000 / Z_HZ_ticks);
+}
+
+/// @brief  Holds the kernel lock, that serializes all kernel object state changes, while in scope.
+///         Waiting threads block on a single futex word, that every state change bumps:
+///         this wakes all of them to re-evaluate their conditions, which is what lets k_poll()
+///         wait on any mix of objects, at the cost of spurious wake-ups under contention.
+class kernel_lock
+{
+  public:
+    kernel_lock();
+    ~kernel_lock();
+    kernel_lock(const kernel_lock&) = delete;
+    kernel_lock& operator=(const kernel_lock&) = delete;
+
+    /// @brief  Temporarily releases the lock, e.g. to run a work item's handler.
+    void release();
+    void acquire();
+
+    /// @brief  Wakes up all waiting threads, call after changing a kernel object's state.
+    void notify_all();
+
+    /// @brief  Blocks until the next notification or the deadline. The kernel lock,
+    ///         and the caller's irq_lock() are released while blocked.
+    /// @param  deadline: the absolute deadline, from @ref to_deadline
+    /// @return false if the deadline has already passed
+    bool wait(std::int64_t deadline);
+
+    /// @brief  Blocks until the condition is satisfied, or the timeout expires.
+    /// @return the final value of the condition
+    template <typename Pred>
+    bool wait_until(k_timeout_t timeout, Pred ready)
+    {
+        if (ready())
+        {
+            return true;
+        }
+        const std::int64_t deadline = to_deadline(timeout);
+        while (wait(deadline))
+        {
+            if (ready())
+            {
+                return true;
+            }
+        }
+        return ready();
+    }
+};
+
+/// @brief  Releases the caller's irq_lock() entirely, before blocking.
+/// @return the nesting depth to restore
+unsigned int irq_release();
+
+/// @brief  Reacquires the caller's irq_lock() after blocking, call without the kernel lock.
+void irq_restore(unsigned int depth);
+
+/// @brief  Updates the states of the poll events from their objects' states.
+/// @return the number of ready events
+int poll_states(::k_poll_event* events, int num_events);
+
+/// @brief  Records the signals' raise counts, so that even pulses are noticed.
+void poll_register(::k_poll_event* events, int num_events);
+
+} // namespace zephyr::host
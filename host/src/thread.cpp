@@ -0,0 +1,263 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sched.h>
+#include <sys/prctl.h>
+#include <unistd.h>
+#include "kernel_lock.hpp"
+
+using namespace zephyr::host;
+
+namespace
+{
+enum thread_state : std::uint8_t
+{
+    started = BIT(0),
+    dead = BIT(1),
+};
+
+thread_local ::k_thread* current_thread{};
+
+/// @brief  Marks the thread dead when its entry function returns, or it aborts itself.
+struct exit_notifier
+{
+    ::k_thread* thread;
+
+    ~exit_notifier()
+    {
+        kernel_lock lock;
+        thread->state |= dead;
+        lock.notify_all();
+    }
+};
+
+void set_host_name(const char* name)
+{
+    // the host limits the names to 15 characters
+    char host_name[16];
+    std::strncpy(host_name, name, sizeof(host_name) - 1);
+    host_name[sizeof(host_name) - 1] = '\0';
+    ::pthread_setname_np(::pthread_self(), host_name);
+}
+
+/// @brief  Sets up the calling host thread to run as a kernel thread.
+void adopt(::k_thread* thread)
+{
+    current_thread = thread;
+    // the default slack delays the timed wake-ups by up to 50 us
+    ::prctl(PR_SET_TIMERSLACK, 1UL);
+}
+
+void* run(void* arg)
+{
+    auto* const thread = static_cast<::k_thread*>(arg);
+    adopt(thread);
+    exit_notifier notifier{thread};
+    if (thread->name[0] != '\0')
+    {
+        set_host_name(thread->name);
+    }
+    if (thread->start_delay != 0)
+    {
+        k_sleep(Z_TIMEOUT_TICKS(thread->start_delay));
+    }
+    thread->entry(thread->p1, thread->p2, thread->p3);
+    return nullptr;
+}
+
+bool is_suspended(const ::k_thread* thread)
+{
+    return __atomic_load_n(&thread->suspended, __ATOMIC_RELAXED);
+}
+
+/// @brief  Blocks the calling thread while it's suspended.
+void suspension_point()
+{
+    ::k_thread* const self = k_current_get();
+    if (is_suspended(self))
+    {
+        kernel_lock lock;
+        lock.wait_until(K_FOREVER, [self] { return !is_suspended(self); });
+    }
+}
+} // namespace
+
+extern "C"
+{
+k_tid_t k_thread_create(struct k_thread* new_thread, k_thread_stack_t* stack, size_t stack_size,
+                        k_thread_entry_t entry, void* p1, void* p2, void* p3, int prio,
+                        uint32_t options, k_timeout_t delay)
+{
+    ARG_UNUSED(stack);
+    ARG_UNUSED(stack_size);
+    ARG_UNUSED(options);
+    *new_thread = {};
+    new_thread->entry = entry;
+    new_thread->p1 = p1;
+    new_thread->p2 = p2;
+    new_thread->p3 = p3;
+    new_thread->prio = prio;
+    if (!K_TIMEOUT_EQ(delay, K_FOREVER))
+    {
+        new_thread->start_delay = delay.ticks;
+        k_thread_start(new_thread);
+    }
+    return new_thread;
+}
+
+void k_thread_start(k_tid_t thread)
+{
+    {
+        kernel_lock lock;
+        if ((thread->state & started) != 0)
+        {
+            return;
+        }
+        thread->state |= started;
+    }
+    const int err = ::pthread_create(&thread->tid, nullptr, &run, thread);
+    if (err != 0)
+    {
+        std::fprintf(stderr, "k_thread_start: %s\n", std::strerror(err));
+        std::abort();
+    }
+    ::pthread_detach(thread->tid);
+}
+
+int k_thread_join(struct k_thread* thread, k_timeout_t timeout)
+{
+    if (thread == k_current_get())
+    {
+        return -EDEADLK;
+    }
+    kernel_lock lock;
+    if (!lock.wait_until(timeout, [thread] { return (thread->state & dead) != 0; }))
+    {
+        return K_TIMEOUT_EQ(timeout, K_NO_WAIT) ? -EBUSY : -EAGAIN;
+    }
+    return 0;
+}
+
+void k_thread_abort(k_tid_t thread)
+{
+    if (thread == k_current_get())
+    {
+        ::pthread_exit(nullptr);
+    }
+    std::fprintf(stderr, "k_thread_abort: only the calling thread can be aborted on the host\n");
+    std::abort();
+}
+
+void k_thread_suspend(k_tid_t thread)
+{
+    {
+        kernel_lock lock;
+        __atomic_store_n(&thread->suspended, true, __ATOMIC_RELAXED);
+    }
+    if (thread == k_current_get())
+    {
+        suspension_point();
+    }
+}
+
+void k_thread_resume(k_tid_t thread)
+{
+    kernel_lock lock;
+    __atomic_store_n(&thread->suspended, false, __ATOMIC_RELAXED);
+    lock.notify_all();
+}
+
+k_tid_t k_current_get(void)
+{
+    if (current_thread == nullptr)
+    {
+        // the threads that the kernel didn't create (e.g. main) are adopted at their first call
+        static thread_local ::k_thread adopted{};
+        adopted.tid = ::pthread_self();
+        adopted.state = started;
+        std::snprintf(adopted.name, sizeof(adopted.name), "%s",
+                      ::getpid() == ::gettid() ? "main" : "host");
+        adopt(&adopted);
+    }
+    return current_thread;
+}
+
+int k_thread_name_set(k_tid_t thread, const char* str)
+{
+    if (thread == nullptr)
+    {
+        thread = k_current_get();
+    }
+    std::snprintf(thread->name, sizeof(thread->name), "%s", str);
+    if (thread == k_current_get())
+    {
+        set_host_name(thread->name);
+    }
+    return 0;
+}
+
+const char* k_thread_name_get(k_tid_t thread)
+{
+    return thread->name;
+}
+
+int k_thread_priority_get(k_tid_t thread)
+{
+    return thread->prio;
+}
+
+void k_thread_priority_set(k_tid_t thread, int prio)
+{
+    thread->prio = prio;
+}
+
+void k_yield(void)
+{
+    suspension_point();
+    ::sched_yield();
+}
+
+int k_is_preempt_thread(void)
+{
+    return k_current_get()->prio >= 0;
+}
+
+int32_t k_sleep(k_timeout_t timeout)
+{
+    suspension_point();
+    if (K_TIMEOUT_EQ(timeout, K_FOREVER))
+    {
+        k_thread_suspend(k_current_get());
+        return K_TICKS_FOREVER;
+    }
+    const std::int64_t deadline = to_deadline(timeout);
+    const ::timespec abs_time = to_timespec(deadline);
+    // like blocking in the kernel, sleeping releases the irq_lock()
+    const unsigned int depth = irq_release();
+    while (::clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &abs_time, nullptr) == EINTR)
+    {
+    }
+    irq_restore(depth);
+    return 0;
+}
+
+int32_t k_usleep(int32_t us)
+{
+    return k_sleep(K_USEC(us));
+}
+
+int32_t k_msleep(int32_t ms)
+{
+    return k_sleep(K_MSEC(ms));
+}
+
+void k_busy_wait(uint32_t usec_to_wait)
+{
+    const std::int64_t deadline = now_ns() + std::int64_t{usec_to_wait} * 1000;
+    while (now_ns() < deadline)
+    {
+    }
+}
+} // extern "C"
@@ -0,0 +1,431 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <algorithm>
+#include <mutex>
+#include <sched.h>
+#include "kernel_lock.hpp"
+
+using namespace zephyr::host;
+
+extern "C"
+{
+struct k_work_q k_sys_work_q;
+}
+
+namespace
+{
+enum queue_flags : std::uint32_t
+{
+    queue_started = BIT(0),
+    queue_busy = BIT(1),
+    queue_draining = BIT(2),
+    queue_plugged = BIT(3),
+    queue_no_yield = BIT(4),
+};
+
+constexpr int system_work_queue_priority = -1;
+constexpr std::uint32_t busy_flags =
+    K_WORK_RUNNING | K_WORK_CANCELING | K_WORK_QUEUED | K_WORK_DELAYED;
+
+/// @brief  Starts the system work queue at the first submission to it,
+///         as the host has no system initialization to start it from.
+void start_system_queue(::k_work_q* queue)
+{
+    static std::once_flag started;
+    if (queue == &k_sys_work_q)
+    {
+        std::call_once(started, [] {
+            ::k_work_queue_config config{};
+            config.name = "sysworkq";
+            k_work_queue_init(&k_sys_work_q);
+            k_work_queue_start(&k_sys_work_q, nullptr, 0, system_work_queue_priority, &config);
+        });
+    }
+}
+
+/// @brief  Converts an absolute deadline to uptime ticks, rounding up.
+k_ticks_t deadline_ticks(std::int64_t deadline)
+{
+    return deadline == forever ? std::numeric_limits<k_ticks_t>::max()
+                               : (deadline + ticks_to_ns(1) - 1) / ticks_to_ns(1);
+}
+
+std::int64_t ticks_deadline(k_ticks_t ticks)
+{
+    return ticks == std::numeric_limits<k_ticks_t>::max() ? forever : ticks_to_ns(ticks);
+}
+
+int submit_locked(::k_work_q* queue, ::k_work* work, kernel_lock& lock)
+{
+    if ((work->flags & K_WORK_CANCELING) != 0)
+    {
+        return -EBUSY;
+    }
+    if ((work->flags & K_WORK_QUEUED) != 0)
+    {
+        return 0;
+    }
+    int ret = 1;
+    if ((work->flags & K_WORK_RUNNING) != 0)
+    {
+        // resubmitted while running, it stays on the same queue
+        queue = work->queue;
+        ret = 2;
+    }
+    if (queue == nullptr)
+    {
+        return -EINVAL;
+    }
+    if ((queue->flags & queue_started) == 0)
+    {
+        return -ENODEV;
+    }
+    if (((queue->flags & (queue_draining | queue_plugged)) != 0) and
+        (k_current_get() != &queue->thread))
+    {
+        return -EBUSY;
+    }
+    sys_slist_append(&queue->pending, &work->node);
+    work->flags |= K_WORK_QUEUED;
+    work->queue = queue;
+    lock.notify_all();
+    return ret;
+}
+
+int cancel_locked(::k_work* work)
+{
+    if ((work->flags & K_WORK_QUEUED) != 0)
+    {
+        sys_slist_find_and_remove(&work->queue->pending, &work->node);
+        work->flags &= ~K_WORK_QUEUED;
+    }
+    if ((work->flags & K_WORK_RUNNING) != 0)
+    {
+        work->flags |= K_WORK_CANCELING;
+    }
+    return static_cast<int>(work->flags & busy_flags);
+}
+
+void unschedule_locked(::k_work_delayable* dwork)
+{
+    if ((dwork->work.flags & K_WORK_DELAYED) != 0)
+    {
+        sys_slist_find_and_remove(&dwork->queue->delayed, &dwork->timeout_node);
+        dwork->work.flags &= ~K_WORK_DELAYED;
+    }
+}
+
+int schedule_locked(::k_work_q* queue, ::k_work_delayable* dwork, k_timeout_t delay,
+                    kernel_lock& lock)
+{
+    if (K_TIMEOUT_EQ(delay, K_NO_WAIT))
+    {
+        return submit_locked(queue, &dwork->work, lock);
+    }
+    dwork->queue = queue;
+    dwork->expires = deadline_ticks(to_deadline(delay));
+    dwork->work.flags |= K_WORK_DELAYED;
+    sys_slist_append(&queue->delayed, &dwork->timeout_node);
+    lock.notify_all();
+    return 1;
+}
+
+/// @brief  Submits the delayed and polling items that are due.
+/// @return the deadline of the next due item
+std::int64_t trigger_locked(::k_work_q* queue, kernel_lock& lock)
+{
+    const std::int64_t now = now_ns();
+    std::int64_t next = forever;
+
+    sys_snode_t* node;
+    sys_snode_t* next_node;
+    sys_snode_t* prev = nullptr;
+    SYS_SLIST_FOR_EACH_NODE_SAFE(&queue->delayed, node, next_node)
+    {
+        auto* const dwork = CONTAINER_OF(node, ::k_work_delayable, timeout_node);
+        const std::int64_t deadline = ticks_deadline(dwork->expires);
+        if (deadline > now)
+        {
+            next = std::min(next, deadline);
+            prev = node;
+            continue;
+        }
+        sys_slist_remove(&queue->delayed, prev, node);
+        dwork->work.flags &= ~K_WORK_DELAYED;
+        submit_locked(queue, &dwork->work, lock);
+    }
+
+    prev = nullptr;
+    SYS_SLIST_FOR_EACH_NODE_SAFE(&queue->polling, node, next_node)
+    {
+        auto* const pwork = CONTAINER_OF(node, ::k_work_poll, poll_node);
+        const std::int64_t deadline = ticks_deadline(pwork->expires);
+        if (poll_states(pwork->events, pwork->num_events) > 0)
+        {
+            pwork->poll_result = 0;
+        }
+        else if (deadline <= now)
+        {
+            pwork->poll_result = -EAGAIN;
+        }
+        else
+        {
+            next = std::min(next, deadline);
+            prev = node;
+            continue;
+        }
+        sys_slist_remove(&queue->polling, prev, node);
+        submit_locked(queue, &pwork->work, lock);
+    }
+    return next;
+}
+
+void run_queue(void* p1, void*, void*)
+{
+    auto* const queue = static_cast<::k_work_q*>(p1);
+    kernel_lock lock;
+    for (;;)
+    {
+        const std::int64_t next = trigger_locked(queue, lock);
+        sys_snode_t* const node = sys_slist_get(&queue->pending);
+        if (node == nullptr)
+        {
+            lock.wait(next);
+            continue;
+        }
+        auto* const work = CONTAINER_OF(node, ::k_work, node);
+        work->flags = (work->flags & ~K_WORK_QUEUED) | K_WORK_RUNNING;
+        queue->flags |= queue_busy;
+        const k_work_handler_t handler = work->handler;
+
+        lock.release();
+        handler(work);
+        lock.acquire();
+
+        work->flags &= ~(K_WORK_RUNNING | K_WORK_CANCELING);
+        queue->flags &= ~queue_busy;
+        lock.notify_all();
+        if ((queue->flags & queue_no_yield) == 0)
+        {
+            lock.release();
+            ::sched_yield();
+            lock.acquire();
+        }
+    }
+}
+} // namespace
+
+extern "C"
+{
+void k_work_init(struct k_work* work, k_work_handler_t handler)
+{
+    *work = {};
+    work->handler = handler;
+}
+
+int k_work_busy_get(const struct k_work* work)
+{
+    kernel_lock lock;
+    return static_cast<int>(work->flags & busy_flags);
+}
+
+int k_work_submit_to_queue(struct k_work_q* queue, struct k_work* work)
+{
+    start_system_queue(queue);
+    kernel_lock lock;
+    return submit_locked(queue, work, lock);
+}
+
+int k_work_submit(struct k_work* work)
+{
+    return k_work_submit_to_queue(&k_sys_work_q, work);
+}
+
+int k_work_cancel(struct k_work* work)
+{
+    kernel_lock lock;
+    return cancel_locked(work);
+}
+
+void k_work_queue_init(struct k_work_q* queue)
+{
+    *queue = {};
+    sys_slist_init(&queue->pending);
+    sys_slist_init(&queue->delayed);
+    sys_slist_init(&queue->polling);
+}
+
+void k_work_queue_start(struct k_work_q* queue, k_thread_stack_t* stack, size_t stack_size,
+                        int prio, const struct k_work_queue_config* cfg)
+{
+    {
+        kernel_lock lock;
+        queue->flags |= queue_started;
+        if ((cfg != nullptr) and cfg->no_yield)
+        {
+            queue->flags |= queue_no_yield;
+        }
+    }
+    k_thread_create(&queue->thread, stack, stack_size, &run_queue, queue, nullptr, nullptr, prio,
+                    0, K_FOREVER);
+    if ((cfg != nullptr) and (cfg->name != nullptr))
+    {
+        k_thread_name_set(&queue->thread, cfg->name);
+    }
+    k_thread_start(&queue->thread);
+}
+
+int k_work_queue_drain(struct k_work_q* queue, bool plug)
+{
+    kernel_lock lock;
+    queue->flags |= queue_draining;
+    if (plug)
+    {
+        queue->flags |= queue_plugged;
+    }
+    const auto drained = [queue] {
+        return sys_slist_is_empty(&queue->pending) and ((queue->flags & queue_busy) == 0);
+    };
+    const bool waited = !drained();
+    lock.wait_until(K_FOREVER, drained);
+    queue->flags &= ~queue_draining;
+    return waited ? 1 : 0;
+}
+
+int k_work_queue_unplug(struct k_work_q* queue)
+{
+    kernel_lock lock;
+    if ((queue->flags & queue_plugged) == 0)
+    {
+        return -EALREADY;
+    }
+    queue->flags &= ~queue_plugged;
+    return 0;
+}
+
+void k_work_init_delayable(struct k_work_delayable* dwork, k_work_handler_t handler)
+{
+    *dwork = {};
+    dwork->work.handler = handler;
+}
+
+int k_work_delayable_busy_get(const struct k_work_delayable* dwork)
+{
+    return k_work_busy_get(&dwork->work);
+}
+
+k_ticks_t k_work_delayable_expires_get(const struct k_work_delayable* dwork)
+{
+    kernel_lock lock;
+    return (dwork->work.flags & K_WORK_DELAYED) != 0 ? dwork->expires : 0;
+}
+
+k_ticks_t k_work_delayable_remaining_get(const struct k_work_delayable* dwork)
+{
+    const k_ticks_t now = k_uptime_ticks();
+    kernel_lock lock;
+    return (dwork->work.flags & K_WORK_DELAYED) != 0 ? std::max<k_ticks_t>(dwork->expires - now, 0)
+                                                     : 0;
+}
+
+int k_work_schedule_for_queue(struct k_work_q* queue, struct k_work_delayable* dwork,
+                              k_timeout_t delay)
+{
+    start_system_queue(queue);
+    kernel_lock lock;
+    if ((dwork->work.flags & busy_flags & ~K_WORK_RUNNING) != 0)
+    {
+        return 0;
+    }
+    return schedule_locked(queue, dwork, delay, lock);
+}
+
+int k_work_schedule(struct k_work_delayable* dwork, k_timeout_t delay)
+{
+    return k_work_schedule_for_queue(&k_sys_work_q, dwork, delay);
+}
+
+int k_work_reschedule_for_queue(struct k_work_q* queue, struct k_work_delayable* dwork,
+                                k_timeout_t delay)
+{
+    start_system_queue(queue);
+    kernel_lock lock;
+    unschedule_locked(dwork);
+    return schedule_locked(queue, dwork, delay, lock);
+}
+
+int k_work_reschedule(struct k_work_delayable* dwork, k_timeout_t delay)
+{
+    return k_work_reschedule_for_queue(&k_sys_work_q, dwork, delay);
+}
+
+int k_work_cancel_delayable(struct k_work_delayable* dwork)
+{
+    kernel_lock lock;
+    unschedule_locked(dwork);
+    return cancel_locked(&dwork->work);
+}
+
+void k_work_poll_init(struct k_work_poll* work, k_work_handler_t handler)
+{
+    *work = {};
+    work->work.handler = handler;
+}
+
+int k_work_poll_submit_to_queue(struct k_work_q* work_q, struct k_work_poll* work,
+                                struct k_poll_event* events, int num_events,
+                                k_timeout_t timeout)
+{
+    if ((events == nullptr) or (num_events <= 0))
+    {
+        return -EINVAL;
+    }
+    start_system_queue(work_q);
+    kernel_lock lock;
+    if ((work->workq != nullptr) and sys_slist_find_and_remove(&work->workq->polling,
+                                                               &work->poll_node))
+    {
+        if (work->workq != work_q)
+        {
+            sys_slist_append(&work->workq->polling, &work->poll_node);
+            return -EADDRINUSE;
+        }
+    }
+    work->workq = work_q;
+    work->events = events;
+    work->num_events = num_events;
+    poll_register(events, num_events);
+    if (poll_states(events, num_events) > 0)
+    {
+        work->poll_result = 0;
+        return std::min(submit_locked(work_q, &work->work, lock), 0);
+    }
+    if (K_TIMEOUT_EQ(timeout, K_NO_WAIT))
+    {
+        work->poll_result = -EAGAIN;
+        return std::min(submit_locked(work_q, &work->work, lock), 0);
+    }
+    work->poll_result = -EINPROGRESS;
+    work->expires = deadline_ticks(to_deadline(timeout));
+    sys_slist_append(&work_q->polling, &work->poll_node);
+    lock.notify_all();
+    return 0;
+}
+
+int k_work_poll_submit(struct k_work_poll* work, struct k_poll_event* events, int num_events,
+                       k_timeout_t timeout)
+{
+    return k_work_poll_submit_to_queue(&k_sys_work_q, work, events, num_events, timeout);
+}
+
+int k_work_poll_cancel(struct k_work_poll* work)
+{
+    kernel_lock lock;
+    if ((work->workq == nullptr) or !sys_slist_find_and_remove(&work->workq->polling,
+                                                               &work->poll_node))
+    {
+        return -EINVAL;
+    }
+    work->poll_result = -ECANCELED;
+    return 0;
+}
+} // extern "C"
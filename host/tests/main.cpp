@@ -0,0 +1,332 @@
+// SPDX-License-Identifier: Apache-2.0
+// Checks the timeouts and wake-up counting of the host backend's kernel API,
+// and of the wrappers built on them.
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include "zephyr/pipe.hpp"
+
+namespace
+{
+constexpr int timeout_ms = 20;
+constexpr unsigned waiter_count = 3;
+
+unsigned failures = 0;
+
+void check(bool condition, const char* what)
+{
+    if (!condition)
+    {
+        printk("FAIL: %s\n", what);
+        ++failures;
+    }
+}
+
+/// @brief  Measures the uptime ticks elapsed while running the function.
+template <typename F>
+k_ticks_t elapsed_ticks(F&& fn)
+{
+    const auto start = ::k_uptime_ticks();
+    fn();
+    return ::k_uptime_ticks() - start;
+}
+
+bool timed_out_in_time(k_ticks_t ticks)
+{
+    return ticks >= static_cast<k_ticks_t>(::k_ms_to_ticks_ceil64(timeout_ms));
+}
+
+K_THREAD_STACK_ARRAY_DEFINE(waiter_stacks, waiter_count, 1024);
+::k_thread waiter_threads[waiter_count];
+std::atomic<int> waiter_results[waiter_count];
+
+/// @brief  Starts the waiter threads, each storing its wait result at its index.
+void start_waiters(int (*wait)(void*), void* object)
+{
+    for (unsigned i = 0; i < waiter_count; ++i)
+    {
+        waiter_results[i] = 1;
+        ::k_thread_create(
+            &waiter_threads[i], waiter_stacks[i], K_THREAD_STACK_SIZEOF(waiter_stacks[i]),
+            [](void* fn, void* obj, void* result) {
+                *static_cast<std::atomic<int>*>(result) = reinterpret_cast<int (*)(void*)>(fn)(obj);
+            },
+            reinterpret_cast<void*>(wait), object, &waiter_results[i], 0, 0, K_NO_WAIT);
+    }
+    // there is no way to observe that they are blocked, give them time to get there
+    ::k_msleep(50);
+}
+
+unsigned finished_waiters()
+{
+    unsigned finished = 0;
+    for (const auto& result : waiter_results)
+    {
+        finished += (result != 1) ? 1 : 0;
+    }
+    return finished;
+}
+
+void join_waiters()
+{
+    for (auto& thread : waiter_threads)
+    {
+        ::k_thread_join(&thread, K_FOREVER);
+    }
+}
+
+void test_uptime()
+{
+    // the first reading latches the epoch
+    check(::k_uptime_ticks() >= 0, "uptime starts non-negative");
+}
+
+void test_semaphore()
+{
+    ::k_sem sem;
+    ::k_sem_init(&sem, 0, 2);
+    check(::k_sem_take(&sem, K_NO_WAIT) == -EBUSY, "sem take without waiting");
+    int err{};
+    const auto ticks = elapsed_ticks([&] { err = ::k_sem_take(&sem, K_MSEC(timeout_ms)); });
+    check(err == -EAGAIN, "sem take timeout result");
+    check(timed_out_in_time(ticks), "sem take timeout duration");
+    ::k_sem_give(&sem);
+    ::k_sem_give(&sem);
+    ::k_sem_give(&sem);
+    check(::k_sem_count_get(&sem) == 2, "sem count limit");
+
+    // each give wakes a waiter, even beyond the limit of the count
+    static ::k_sem binary;
+    ::k_sem_init(&binary, 0, 1);
+    start_waiters(
+        [](void* obj) { return ::k_sem_take(static_cast<::k_sem*>(obj), K_FOREVER); }, &binary);
+    for (unsigned i = 0; i < waiter_count; ++i)
+    {
+        ::k_sem_give(&binary);
+    }
+    join_waiters();
+    check(::k_sem_count_get(&binary) == 0, "sem gives are handed to the waiters");
+}
+
+void test_message_queue()
+{
+    char buffer[2 * sizeof(std::uint32_t)];
+    ::k_msgq msgq;
+    ::k_msgq_init(&msgq, buffer, sizeof(std::uint32_t), 2);
+    std::uint32_t value = 0;
+    check(::k_msgq_get(&msgq, &value, K_NO_WAIT) == -ENOMSG, "msgq get without waiting");
+    int err{};
+    auto ticks = elapsed_ticks([&] { err = ::k_msgq_get(&msgq, &value, K_MSEC(timeout_ms)); });
+    check(err == -EAGAIN, "msgq get timeout result");
+    check(timed_out_in_time(ticks), "msgq get timeout duration");
+
+    for (std::uint32_t i = 1; i <= 2; ++i)
+    {
+        check(::k_msgq_put(&msgq, &i, K_NO_WAIT) == 0, "msgq put");
+    }
+    check(::k_msgq_put(&msgq, &value, K_NO_WAIT) == -ENOMSG, "msgq put without waiting");
+    ticks = elapsed_ticks([&] { err = ::k_msgq_put(&msgq, &value, K_MSEC(timeout_ms)); });
+    check(err == -EAGAIN, "msgq put timeout result");
+    check(timed_out_in_time(ticks), "msgq put timeout duration");
+    check((::k_msgq_get(&msgq, &value, K_NO_WAIT) == 0) and (value == 1), "msgq order");
+}
+
+void test_event()
+{
+    ::k_event event;
+    ::k_event_init(&event);
+    std::uint32_t events{};
+    const auto ticks =
+        elapsed_ticks([&] { events = ::k_event_wait(&event, BIT(0), false, K_MSEC(timeout_ms)); });
+    check(events == 0, "event wait timeout result");
+    check(timed_out_in_time(ticks), "event wait timeout duration");
+
+    start_waiters(
+        [](void* obj) {
+            return static_cast<int>(
+                ::k_event_wait(static_cast<::k_event*>(obj), BIT(1), false, K_FOREVER));
+        },
+        &event);
+    ::k_event_post(&event, BIT(0));
+    ::k_msleep(10);
+    check(finished_waiters() == 0, "event wait ignores other events");
+    ::k_event_post(&event, BIT(1));
+    join_waiters();
+    for (const auto& result : waiter_results)
+    {
+        check(result == BIT(1), "event wait result");
+    }
+}
+
+void test_work()
+{
+    static ::k_sem done;
+    ::k_sem_init(&done, 0, 1);
+    const auto handler = [](::k_work*) { ::k_sem_give(&done); };
+
+    ::k_work work;
+    ::k_work_init(&work, handler);
+    check(::k_work_submit(&work) == 1, "work submit");
+    check(::k_sem_take(&done, K_MSEC(1000)) == 0, "work runs");
+
+    ::k_work_delayable dwork;
+    ::k_work_init_delayable(&dwork, handler);
+    const auto ticks = elapsed_ticks([&] {
+        ::k_work_schedule(&dwork, K_MSEC(timeout_ms));
+        check(::k_sem_take(&done, K_MSEC(1000)) == 0, "delayable work runs");
+    });
+    check(timed_out_in_time(ticks), "delayable work delay");
+
+    ::k_work_schedule(&dwork, K_MSEC(timeout_ms));
+    ::k_work_cancel_delayable(&dwork);
+    check(::k_sem_take(&done, K_MSEC(2 * timeout_ms)) == -EAGAIN, "cancelled work doesn't run");
+}
+
+void test_poll()
+{
+    ::k_sem sem;
+    ::k_sem_init(&sem, 0, 1);
+    ::k_poll_signal signal;
+    ::k_poll_signal_init(&signal);
+    ::k_poll_event events[2];
+    ::k_poll_event_init(&events[0], K_POLL_TYPE_SEM_AVAILABLE, K_POLL_MODE_NOTIFY_ONLY, &sem);
+    ::k_poll_event_init(&events[1], K_POLL_TYPE_SIGNAL, K_POLL_MODE_NOTIFY_ONLY, &signal);
+    int err{};
+    const auto ticks = elapsed_ticks([&] { err = ::k_poll(events, 2, K_MSEC(timeout_ms)); });
+    check(err == -EAGAIN, "poll timeout result");
+    check(timed_out_in_time(ticks), "poll timeout duration");
+
+    events[0].state = events[1].state = K_POLL_STATE_NOT_READY;
+    ::k_poll_signal_raise(&signal, 7);
+    check(::k_poll(events, 2, K_NO_WAIT) == 0, "poll signaled");
+    check((events[0].state == K_POLL_STATE_NOT_READY) and
+              (events[1].state == K_POLL_STATE_SIGNALED),
+          "poll signaled state");
+
+    events[0].state = events[1].state = K_POLL_STATE_NOT_READY;
+    ::k_poll_signal_reset(&signal);
+    ::k_sem_give(&sem);
+    check(::k_poll(events, 2, K_NO_WAIT) == 0, "poll sem available");
+    check(events[0].state == K_POLL_STATE_SEM_AVAILABLE, "poll sem available state");
+}
+
+::k_mutex condvar_mutex;
+
+void test_condvar()
+{
+    static ::k_condvar condvar;
+    ::k_mutex_init(&condvar_mutex);
+    ::k_condvar_init(&condvar);
+
+    ::k_mutex_lock(&condvar_mutex, K_FOREVER);
+    int err{};
+    const auto ticks = elapsed_ticks(
+        [&] { err = ::k_condvar_wait(&condvar, &condvar_mutex, K_MSEC(timeout_ms)); });
+    check(err == -EAGAIN, "condvar wait timeout result");
+    check(timed_out_in_time(ticks), "condvar wait timeout duration");
+    check(::k_mutex_unlock(&condvar_mutex) == 0, "condvar wait timeout reacquires the mutex");
+
+    check(::k_condvar_broadcast(&condvar) == 0, "condvar broadcast without waiters");
+    start_waiters(
+        [](void* obj) {
+            ::k_mutex_lock(&condvar_mutex, K_FOREVER);
+            const int result = ::k_condvar_wait(static_cast<::k_condvar*>(obj), &condvar_mutex,
+                                                K_FOREVER);
+            ::k_mutex_unlock(&condvar_mutex);
+            return result;
+        },
+        &condvar);
+    check(::k_condvar_signal(&condvar) == 0, "condvar signal");
+    ::k_msleep(10);
+    check(finished_waiters() == 1, "condvar signal wakes one waiter");
+    check(::k_condvar_broadcast(&condvar) == waiter_count - 1, "condvar broadcast wakes the rest");
+    join_waiters();
+    for (const auto& result : waiter_results)
+    {
+        check(result == 0, "condvar wait result");
+    }
+}
+
+void test_futex()
+{
+    static ::k_futex futex;
+    ::atomic_set(&futex.val, 1);
+    check(::k_futex_wait(&futex, 0, K_FOREVER) == -EAGAIN, "futex wait on a changed value");
+    int err{};
+    const auto ticks = elapsed_ticks([&] { err = ::k_futex_wait(&futex, 1, K_MSEC(timeout_ms)); });
+    check(err == -ETIMEDOUT, "futex wait timeout result");
+    check(timed_out_in_time(ticks), "futex wait timeout duration");
+    check(::k_futex_wake(&futex, true) == 0, "futex wake without waiters");
+
+    start_waiters(
+        [](void* obj) { return ::k_futex_wait(static_cast<::k_futex*>(obj), 1, K_FOREVER); },
+        &futex);
+    check(::k_futex_wake(&futex, false) == 1, "futex wake one");
+    ::k_msleep(10);
+    check(finished_waiters() == 1, "futex wake one wakes one waiter");
+    check(::k_futex_wake(&futex, true) == waiter_count - 1, "futex wake all wakes the rest");
+    join_waiters();
+    for (const auto& result : waiter_results)
+    {
+        check(result == 0, "futex wait result");
+    }
+}
+zephyr::pipe_instance<16> pipe;
+
+/// @brief  Blocked reader of the pipe, with its own minimal number of bytes.
+struct pipe_reader
+{
+    std::size_t min_bytes;
+    std::atomic<int> result{-1};
+};
+
+void test_pipe()
+{
+    using namespace std::chrono_literals;
+    static pipe_reader readers[] = {{10}, {1}};
+    for (unsigned i = 0; i < std::size(readers); ++i)
+    {
+        ::k_thread_create(
+            &waiter_threads[i], waiter_stacks[i], K_THREAD_STACK_SIZEOF(waiter_stacks[i]),
+            [](void* p1, void*, void*) {
+                auto& reader = *static_cast<pipe_reader*>(p1);
+                std::byte data[16];
+                reader.result = static_cast<int>(pipe.try_read_for(data, reader.min_bytes, 1s));
+            },
+            &readers[i], nullptr, nullptr, 0, 0, K_NO_WAIT);
+        // the reader with the higher threshold blocks first
+        ::k_msleep(20);
+    }
+    const std::byte data[10]{};
+    check(pipe.try_write(std::span(data, 5)) == 5, "pipe write");
+    ::k_msleep(20);
+    check(readers[1].result == 5, "pipe wakes the reader with a lower threshold");
+    check(readers[0].result == -1, "pipe reader waits for its threshold");
+    check(pipe.try_write(data) == 10, "pipe write more");
+    for (unsigned i = 0; i < std::size(readers); ++i)
+    {
+        ::k_thread_join(&waiter_threads[i], K_FOREVER);
+    }
+    check(readers[0].result == 10, "pipe reader with a higher threshold");
+
+    std::byte buffer[16];
+    check(pipe.try_read_for(buffer, 0, 1s) == 0, "pipe read of zero bytes doesn't block");
+}
+} // namespace
+
+int main()
+{
+    test_uptime();
+    test_semaphore();
+    test_message_queue();
+    test_event();
+    test_work();
+    test_poll();
+    test_condvar();
+    test_futex();
+    test_pipe();
+    printk("host tests %s (%u failures)\n", failures == 0 ? "passed" : "failed", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,253 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <zephyr/sys/util.h>
+#include "zephyr/tick_timer.hpp"
+
+namespace zephyr
+{
+/// @brief  Single use downward counter, equivalent of std::latch: the waiting threads
+///         are released together when the counter reaches zero.
+///         Waiting on a released latch doesn't call into the kernel.
+class latch
+{
+  public:
+    latch(const latch&) = delete;
+    latch& operator=(const latch&) = delete;
+
+    /// @param  expected: the initial value of the counter
+    explicit latch(std::ptrdiff_t expected) : count_(expected)
+    {
+        __ASSERT_NO_MSG((expected >= 0) and (expected <= max()));
+        ::k_event_init(&released_);
+        if (expected == 0)
+        {
+            ::k_event_post(&released_, released_flag);
+        }
+    }
+
+    static constexpr std::ptrdiff_t max() noexcept { return PTRDIFF_MAX; }
+
+    /// @brief  Decrements the counter, and releases the waiting threads when it reaches zero.
+    /// @param  update: the value to decrement the counter by
+    /// @remark Thread and ISR context callable
+    void count_down(std::ptrdiff_t update = 1)
+    {
+        const std::ptrdiff_t previous = count_.fetch_sub(update, std::memory_order_acq_rel);
+        __ASSERT_NO_MSG((update >= 0) and (previous >= update));
+        if (previous == update)
+        {
+            ::k_event_post(&released_, released_flag);
+        }
+    }
+
+    /// @return true if the counter has reached zero
+    /// @remark Thread and ISR context callable
+    bool try_wait() const noexcept { return count_.load(std::memory_order_acquire) == 0; }
+
+    /// @brief  Blocks the current thread until the counter reaches zero.
+    /// @remark Thread context callable
+    void wait() const { try_wait_for(infinity); }
+
+    /// @brief  Blocks the current thread until the counter reaches zero.
+    /// @param  rel_time: duration to wait for the release
+    /// @return true if the counter has reached zero, false if timed out
+    /// @remark Thread context callable
+    template <class Rep, class Period>
+    bool try_wait_for(const std::chrono::duration<Rep, Period>& rel_time) const
+    {
+        return wait_with(to_timeout(rel_time));
+    }
+
+    /// @brief  Blocks the current thread until the counter reaches zero.
+    /// @param  abs_time: deadline to wait for the release
+    /// @return true if the counter has reached zero, false if timed out
+    /// @remark Thread context callable
+    template <class Clock, class Duration>
+    bool try_wait_until(const std::chrono::time_point<Clock, Duration>& abs_time) const
+    {
+        return wait_with(timeout_until(abs_time));
+    }
+
+    /// @brief  Decrements the counter, then blocks until it reaches zero.
+    /// @param  update: the value to decrement the counter by
+    /// @remark Thread context callable
+    void arrive_and_wait(std::ptrdiff_t update = 1)
+    {
+        count_down(update);
+        wait();
+    }
+
+  private:
+    static constexpr std::uint32_t released_flag = BIT(0);
+
+    bool wait_with(k_timeout_t timeout) const
+    {
+        return try_wait() or (::k_event_wait(&released_, released_flag, false, timeout) != 0);
+    }
+
+    std::atomic<std::ptrdiff_t> count_;
+    mutable ::k_event released_;
+};
+
+/// @brief  The default completion function of @ref barrier, that does nothing.
+struct no_completion
+{
+    void operator()() const noexcept {}
+};
+
+/// @brief  Reusable thread coordination mechanism, equivalent of std::barrier:
+///         each phase completes when the expected number of threads have arrived,
+///         then the completion function runs, and the waiting threads are released.
+///         A phase costs the minimum of kernel interactions:
+///          1. the arrivals are counted with atomic operations, outside the kernel
+///          2. the last arriving thread doesn't block, it runs the completion function
+///             in its own context, and continues with the next phase
+///          3. a single kernel call releases all waiting threads of the phase at once,
+///             and threads that wait on a completed phase don't call into the kernel
+/// @tparam CompletionFunction: function object run once per phase, before the waiting threads
+///         are released, it must not throw
+template <typename CompletionFunction = no_completion>
+class barrier
+{
+    static_assert(std::is_nothrow_invocable_v<CompletionFunction&>);
+
+    // the phase and the count of missing arrivals share a word, so the arrivals
+    // of the next phase can't be mixed up with the previous one
+    static constexpr unsigned count_bits = 24;
+    static constexpr std::uint32_t count_mask = (std::uint32_t{1} << count_bits) - 1;
+    static constexpr std::uint32_t phase_mask = UINT32_MAX >> count_bits;
+
+  public:
+    /// @brief  The phase that the thread arrived at, to wait for its completion.
+    class arrival_token
+    {
+      private:
+        friend barrier;
+        explicit arrival_token(std::uint32_t phase) : phase_(phase) {}
+        std::uint32_t phase_;
+    };
+
+    barrier(const barrier&) = delete;
+    barrier& operator=(const barrier&) = delete;
+
+    /// @param  expected: the number of threads that participate in each phase
+    /// @param  completion: the function to run at the completion of each phase
+    explicit barrier(std::ptrdiff_t expected, CompletionFunction completion = CompletionFunction())
+        : completion_(std::move(completion)),
+          expected_(static_cast<std::uint32_t>(expected)),
+          state_(static_cast<std::uint32_t>(expected))
+    {
+        __ASSERT_NO_MSG((expected >= 0) and (expected <= max()));
+        ::k_event_init(&completed_);
+    }
+
+    static constexpr std::ptrdiff_t max() noexcept { return count_mask; }
+
+    /// @brief  Arrives at the current phase, without waiting for its completion.
+    ///         The last arrival completes the phase.
+    /// @param  update: the number of arrivals to count
+    /// @return the token to wait for the phase's completion with
+    /// @remark Thread context callable
+    [[nodiscard]] arrival_token arrive(std::ptrdiff_t update = 1)
+    {
+        const std::uint32_t previous =
+            state_.fetch_sub(static_cast<std::uint32_t>(update), std::memory_order_acq_rel);
+        const std::uint32_t phase = previous >> count_bits;
+        __ASSERT_NO_MSG((update > 0) and ((previous & count_mask) >= std::uint32_t(update)));
+        if ((previous & count_mask) == std::uint32_t(update))
+        {
+            complete(phase);
+        }
+        return arrival_token(phase);
+    }
+
+    /// @brief  Blocks the current thread until the phase of the token completes.
+    /// @param  token: the token from @ref arrive
+    /// @remark Thread context callable
+    void wait(arrival_token&& token) const
+    {
+        wait_phase(token.phase_, tick_timer::time_point::max());
+    }
+
+    /// @brief  Blocks the current thread until the phase of the token completes.
+    /// @param  token: the token from @ref arrive
+    /// @param  rel_time: duration to wait for the completion
+    /// @return true if the phase completed, false if timed out
+    /// @remark Thread context callable
+    template <class Rep, class Period>
+    bool try_wait_for(const arrival_token& token,
+                      const std::chrono::duration<Rep, Period>& rel_time) const
+    {
+        return wait_phase(token.phase_, detail::to_deadline(rel_time));
+    }
+
+    /// @brief  Blocks the current thread until the phase of the token completes.
+    /// @param  token: the token from @ref arrive
+    /// @param  abs_time: deadline to wait for the completion
+    /// @return true if the phase completed, false if timed out
+    /// @remark Thread context callable
+    template <class Clock, class Duration>
+    bool try_wait_until(const arrival_token& token,
+                        const std::chrono::time_point<Clock, Duration>& abs_time) const
+    {
+        return wait_phase(token.phase_, detail::to_deadline(abs_time));
+    }
+
+    /// @brief  Arrives at the current phase, and blocks until it completes.
+    /// @remark Thread context callable
+    void arrive_and_wait() { wait(arrive()); }
+
+    /// @brief  Arrives at the current phase, and leaves the following phases,
+    ///         decrementing the number of expected threads.
+    /// @remark Thread context callable
+    void arrive_and_drop()
+    {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        (void)arrive();
+    }
+
+  private:
+    static std::uint32_t phase_flag(std::uint32_t phase) { return BIT(phase & 1); }
+
+    std::uint32_t current_phase() const
+    {
+        return state_.load(std::memory_order_acquire) >> count_bits;
+    }
+
+    void complete(std::uint32_t phase)
+    {
+        completion_();
+        expected_ -= dropped_.exchange(0, std::memory_order_relaxed);
+        const std::uint32_t next = (phase + 1) & phase_mask;
+        state_.store((next << count_bits) | expected_, std::memory_order_release);
+        // the waiters of each phase wait for the flag of the next one, and setting it
+        // clears the flag that the waiters of the next phase will wait for
+        ::k_event_set(&completed_, phase_flag(next));
+    }
+
+    bool wait_phase(std::uint32_t phase, const tick_timer::time_point& deadline) const
+    {
+        while (current_phase() == phase)
+        {
+            if (::k_event_wait(&completed_, phase_flag(phase + 1), false,
+                               detail::deadline_timeout(deadline)) == 0)
+            {
+                return current_phase() != phase;
+            }
+        }
+        return true;
+    }
+
+    [[no_unique_address]] CompletionFunction completion_;
+    std::uint32_t expected_;
+    std::atomic<std::uint32_t> dropped_{};
+    std::atomic<std::uint32_t> state_;
+    mutable ::k_event completed_;
+};
+
+} // namespace zephyr
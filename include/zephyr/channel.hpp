@@ -0,0 +1,259 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <zephyr/zbus/zbus.h>
+#include "zephyr/message_queue.hpp"
+#include "zephyr/tick_timer.hpp"
+
+namespace zephyr
+{
+/// @brief  The message queue that a zbus subscriber is notified through, it receives
+///         the pointers of the published channels. Bind it to a subscriber with
+///         @ref ZEPHYR_CHANNEL_SUBSCRIBER_DEFINE.
+/// @tparam SIZE: the maximal number of pending notifications
+template <std::size_t SIZE>
+using subscriber_queue = message_queue_instance<const ::zbus_channel*, SIZE>;
+
+namespace detail
+{
+constexpr ::zbus_observer_data enabled_observer_data()
+{
+    ::zbus_observer_data data{};
+    data.enabled = true;
+#ifdef CONFIG_ZBUS_PRIORITY_BOOST
+    data.priority = ZBUS_MIN_THREAD_PRIORITY;
+#endif
+    return data;
+}
+} // namespace detail
+
+/// @brief  Typed view of a zbus channel (requires CONFIG_ZBUS), defined with
+///         ZBUS_CHAN_DEFINE. Each message is published once, and delivered
+///         to all observers of the channel: listeners are called synchronously
+///         by the publisher, and read the message in place, subscribers get notified
+///         through their message queue, and read the message afterwards.
+/// @tparam T: the message type of the channel
+template <typename T>
+class channel
+{
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "zbus copies messages bytewise, T must be trivially copyable");
+
+  public:
+    /// @brief  Exclusive, in place access to the channel's message, released
+    ///         when the object is destroyed.
+    class claimed
+    {
+      public:
+        claimed(const claimed&) = delete;
+        claimed& operator=(const claimed&) = delete;
+        claimed(claimed&& other) : chan_(std::exchange(other.chan_, nullptr)) {}
+        claimed& operator=(claimed&&) = delete;
+
+        ~claimed()
+        {
+            if (chan_ != nullptr)
+            {
+                ::zbus_chan_finish(chan_);
+            }
+        }
+
+        T& operator*() const { return *static_cast<T*>(::zbus_chan_msg(chan_)); }
+        T* operator->() const { return static_cast<T*>(::zbus_chan_msg(chan_)); }
+
+        /// @brief  Releases the message, and notifies the observers of the channel,
+        ///         as if the modified message was published.
+        /// @remark Thread context callable
+        void publish()
+        {
+            const ::zbus_channel* chan = std::exchange(chan_, nullptr);
+            ::zbus_chan_finish(chan);
+            ::zbus_chan_notify(chan, K_FOREVER);
+        }
+
+      private:
+        friend class channel;
+        explicit claimed(const ::zbus_channel& chan) : chan_(&chan) {}
+
+        const ::zbus_channel* chan_;
+    };
+
+    /// @param  chan: the channel, defined with the message type T
+    explicit channel(const ::zbus_channel& chan) : chan_(chan)
+    {
+        __ASSERT_NO_MSG(chan.message_size == sizeof(T));
+    }
+
+    /// @brief  Publishes the message to the observers of the channel,
+    ///         waiting for the channel until it's available.
+    /// @param  msg: the message to publish
+    /// @return false if the channel's validator rejected the message
+    /// @remark Thread context callable
+    bool publish(const T& msg) { return ::zbus_chan_pub(&chan_, &msg, K_FOREVER) == 0; }
+
+    /// @brief  Publishes the message to the observers of the channel.
+    /// @param  msg: the message to publish
+    /// @param  rel_time: duration to wait for the channel, and for each subscriber's queue
+    /// @return true if the message was published, false if timed out or rejected
+    /// @remark Thread context callable, or in ISR context without waiting
+    template <class Rep, class Period>
+    bool try_publish_for(const T& msg, const std::chrono::duration<Rep, Period>& rel_time)
+    {
+        return ::zbus_chan_pub(&chan_, &msg, to_timeout(rel_time)) == 0;
+    }
+
+    /// @brief  Publishes the message to the observers of the channel.
+    /// @param  msg: the message to publish
+    /// @param  abs_time: deadline to wait for the channel, and for the subscribers' queues
+    /// @return true if the message was published, false if timed out or rejected
+    /// @remark Thread context callable
+    template <class Clock, class Duration>
+    bool try_publish_until(const T& msg, const std::chrono::time_point<Clock, Duration>& abs_time)
+    {
+        return ::zbus_chan_pub(&chan_, &msg, timeout_until(abs_time)) == 0;
+    }
+
+    /// @brief  Copies the last published message, waiting for the channel
+    ///         until it's available.
+    /// @return the message
+    /// @remark Thread context callable
+    T read() const
+    {
+        T msg;
+        ::zbus_chan_read(&chan_, &msg, K_FOREVER);
+        return msg;
+    }
+
+    /// @brief  Copies the last published message.
+    /// @param  rel_time: duration to wait for the channel
+    /// @return the message, or empty if timed out
+    /// @remark Thread context callable, or in ISR context without waiting
+    template <class Rep, class Period>
+    std::optional<T> try_read_for(const std::chrono::duration<Rep, Period>& rel_time) const
+    {
+        return read(to_timeout(rel_time));
+    }
+
+    /// @brief  Copies the last published message.
+    /// @param  abs_time: deadline to wait for the channel
+    /// @return the message, or empty if timed out
+    /// @remark Thread context callable
+    template <class Clock, class Duration>
+    std::optional<T> try_read_until(const std::chrono::time_point<Clock, Duration>& abs_time) const
+    {
+        return read(timeout_until(abs_time));
+    }
+
+    /// @brief  Takes exclusive access to the message in place, to read or modify it
+    ///         without copying, waiting for the channel until it's available.
+    /// @return the claim, releasing the channel when destroyed
+    /// @remark Thread context callable
+    claimed claim()
+    {
+        ::zbus_chan_claim(&chan_, K_FOREVER);
+        return claimed(chan_);
+    }
+
+    /// @brief  Takes exclusive access to the message in place.
+    /// @param  rel_time: duration to wait for the channel
+    /// @return the claim, or empty if timed out
+    /// @remark Thread context callable
+    template <class Rep, class Period>
+    std::optional<claimed> try_claim_for(const std::chrono::duration<Rep, Period>& rel_time)
+    {
+        return try_claim(to_timeout(rel_time));
+    }
+
+    /// @brief  Takes exclusive access to the message in place.
+    /// @param  abs_time: deadline to wait for the channel
+    /// @return the claim, or empty if timed out
+    /// @remark Thread context callable
+    template <class Clock, class Duration>
+    std::optional<claimed> try_claim_until(const std::chrono::time_point<Clock, Duration>& abs_time)
+    {
+        return try_claim(timeout_until(abs_time));
+    }
+
+    /// @brief  Checks whether a subscriber notification comes from this channel.
+    bool operator==(const ::zbus_channel* chan) const { return chan == &chan_; }
+
+    const ::zbus_channel& get() const { return chan_; }
+
+    /// @brief  Listener callback, for ZBUS_LISTENER_DEFINE, that calls FN with the published
+    ///         message in place. The channel is held while FN runs, so it must not
+    ///         block, or access the channel itself.
+    /// @tparam FN: invocable with a const T& message, e.g. a captureless lambda
+    template <auto FN>
+    static void listener(const ::zbus_channel* chan)
+    {
+        FN(*static_cast<const T*>(::zbus_chan_const_msg(chan)));
+    }
+
+#ifdef CONFIG_ZBUS_RUNTIME_OBSERVERS
+    /// @brief  Adds an observer to the channel at runtime.
+    /// @param  obs: the observer, defined with ZBUS_LISTENER_DEFINE,
+    ///         ZBUS_SUBSCRIBER_DEFINE or @ref ZEPHYR_CHANNEL_SUBSCRIBER_DEFINE
+    /// @param  rel_time: duration to wait for the channel
+    /// @return true if the observer was added, false if timed out or already added
+    /// @remark Thread context callable
+    template <class Rep = tick_timer::rep, class Period = tick_timer::period>
+    bool add_observer(const ::zbus_observer& obs,
+                      const std::chrono::duration<Rep, Period>& rel_time = infinity)
+    {
+        return ::zbus_chan_add_obs(&chan_, &obs, to_timeout(rel_time)) == 0;
+    }
+
+    /// @brief  Removes an observer that was added at runtime.
+    /// @param  obs: the observer to remove
+    /// @param  rel_time: duration to wait for the channel
+    /// @return true if the observer was removed, false if timed out or not found
+    /// @remark Thread context callable
+    template <class Rep = tick_timer::rep, class Period = tick_timer::period>
+    bool remove_observer(const ::zbus_observer& obs,
+                         const std::chrono::duration<Rep, Period>& rel_time = infinity)
+    {
+        return ::zbus_chan_rm_obs(&chan_, &obs, to_timeout(rel_time)) == 0;
+    }
+#endif
+
+  private:
+    std::optional<T> read(k_timeout_t timeout) const
+    {
+        std::optional<T> msg{std::in_place};
+        if (::zbus_chan_read(&chan_, &*msg, timeout) != 0)
+        {
+            msg.reset();
+        }
+        return msg;
+    }
+
+    std::optional<claimed> try_claim(k_timeout_t timeout)
+    {
+        if (::zbus_chan_claim(&chan_, timeout) != 0)
+        {
+            return std::nullopt;
+        }
+        return claimed(chan_);
+    }
+
+    const ::zbus_channel& chan_;
+};
+
+} // namespace zephyr
+
+/// @brief  Defines a zbus subscriber, that is notified through an existing
+///         @ref zephyr::subscriber_queue (or any message_queue of channel pointers),
+///         instead of a queue of its own, like ZBUS_SUBSCRIBER_DEFINE.
+/// @param  name: the name of the observer
+/// @param  msgq: the message queue to notify
+#define ZEPHYR_CHANNEL_SUBSCRIBER_DEFINE(name, msgq)                                               \
+    static ::zbus_observer_data _zephyr_zbus_obs_data_##name =                                     \
+        ::zephyr::detail::enabled_observer_data();                                                 \
+    const STRUCT_SECTION_ITERABLE(zbus_observer, name) = {                                         \
+        ZBUS_OBSERVER_NAME_INIT(name)                                                              \
+        .type = ZBUS_OBSERVER_SUBSCRIBER_TYPE,                                                     \
+        .data = &_zephyr_zbus_obs_data_##name,                                                     \
+        .queue = &(msgq),                                                                          \
+    }
@@ -0,0 +1,474 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+#include <coroutine>
+#include <exception>
+#include "zephyr/cpu.hpp"
+#include "zephyr/event_group.hpp"
+#include "zephyr/message_queue.hpp"
+#include "zephyr/polling.hpp"
+#include "zephyr/work_queue.hpp"
+
+namespace zephyr
+{
+namespace detail
+{
+/// @brief  Intrusive node of the @ref executor ready list.
+struct resumable
+{
+    ::sys_snode_t node{};
+    void (*on_ready)(resumable*){};
+};
+} // namespace detail
+
+/// @brief  Runs stackless @ref task coroutines on a work queue. Every time a task
+///         becomes ready, it is resumed from the executor's work item,
+///         so all tasks of an executor share the stack of the work queue thread.
+class executor
+{
+  public:
+    explicit executor(::k_work_q& queue = ::k_sys_work_q) : queue_(&queue)
+    {
+        ::sys_slist_init(&ready_);
+    }
+    executor(const executor&) = delete;
+    executor& operator=(const executor&) = delete;
+
+    /// @brief  The executor running on the system work queue.
+    static executor& system()
+    {
+        static executor exec;
+        return exec;
+    }
+
+    ::k_work_q& queue() { return *queue_; }
+
+    /// @brief  Schedules the ready callback of the node on the work queue.
+    /// @remark Thread and ISR context callable
+    void post(detail::resumable& r)
+    {
+        {
+            critical_section cs(lock_);
+            ::sys_slist_append(&ready_, &r.node);
+        }
+        ::k_work_submit_to_queue(queue_, &work_);
+    }
+
+  private:
+    static void run(work* w)
+    {
+        auto* self = CONTAINER_OF(w, executor, work_);
+        for (;;)
+        {
+            ::sys_snode_t* node;
+            {
+                critical_section cs(self->lock_);
+                node = ::sys_slist_get(&self->ready_);
+            }
+            if (node == nullptr)
+            {
+                break;
+            }
+            auto* r = CONTAINER_OF(node, detail::resumable, node);
+            r->on_ready(r);
+        }
+    }
+
+    work work_{&run};
+    ::k_work_q* queue_;
+    ::sys_slist_t ready_;
+    spinlock lock_{};
+};
+
+/// @brief  Fire-and-forget coroutine type. The coroutine starts on its @ref executor,
+///         which is the system one, unless the coroutine's first parameter is an executor.
+///         Its frame is freed when the coroutine returns.
+class task
+{
+  public:
+    struct promise_type : detail::resumable
+    {
+        promise_type() = default;
+        template <typename... Args>
+        promise_type(executor& exec, Args&...) : exec(&exec)
+        {}
+
+        task get_return_object() noexcept { return {}; }
+        auto initial_suspend() noexcept
+        {
+            struct schedule
+            {
+                bool await_ready() const noexcept { return false; }
+                void await_suspend(std::coroutine_handle<promise_type> h) const noexcept
+                {
+                    auto& p = h.promise();
+                    p.on_ready = &resume;
+                    p.exec->post(p);
+                }
+                void await_resume() const noexcept {}
+            };
+            return schedule{};
+        }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+
+        executor* exec = &executor::system();
+
+      private:
+        static void resume(detail::resumable* r)
+        {
+            std::coroutine_handle<promise_type>::from_promise(*static_cast<promise_type*>(r))
+                .resume();
+        }
+    };
+};
+
+namespace detail
+{
+/// @brief  Suspends the awaiting @ref task until the polled kernel object is ready,
+///         then lets the Derived class take the object (without blocking).
+///         Losing the race for the object to another consumer rearms the poll.
+template <class Derived>
+class poll_awaiter : public resumable
+{
+  public:
+    poll_awaiter(const poll_awaiter&) = delete;
+    poll_awaiter& operator=(const poll_awaiter&) = delete;
+
+    bool await_ready() { return derived().try_complete(); }
+
+    void await_suspend(std::coroutine_handle<task::promise_type> h)
+    {
+        handle_ = h;
+        exec_ = h.promise().exec;
+        on_ready = &ready;
+        submit();
+    }
+
+  protected:
+    template <typename Object>
+    poll_awaiter(Object& obj, tick_timer::time_point deadline) : event_(obj), deadline_(deadline)
+    {}
+
+  private:
+    Derived& derived() { return static_cast<Derived&>(*this); }
+
+    void submit()
+    {
+        event_.reset_state();
+        trigger_.work.submit_to(exec_->queue(), std::span<poll_event>(&event_, 1),
+                                remaining(deadline_));
+        if constexpr (Derived::check_after_submit)
+        {
+            // the polled object only signals the updates, check the current state
+            if (derived().try_complete())
+            {
+                completed_ = true;
+                if (trigger_.work.cancel() == 0)
+                {
+                    exec_->post(*this);
+                }
+            }
+        }
+    }
+
+    static void triggered(work_poll* w)
+    {
+        auto* self = CONTAINER_OF(w, trigger, work)->owner;
+        self->exec_->post(*self);
+    }
+
+    static void ready(resumable* r)
+    {
+        auto* self = static_cast<poll_awaiter*>(r);
+        if (!self->completed_ and (self->event_.state != K_POLL_STATE_NOT_READY) and
+            !self->derived().try_complete() and !expired(self->deadline_))
+        {
+            self->submit();
+            return;
+        }
+        self->handle_.resume();
+    }
+
+    struct trigger
+    {
+        explicit trigger(poll_awaiter* owner) : work(&triggered), owner(owner) {}
+        work_poll work;
+        poll_awaiter* owner;
+    };
+
+    trigger trigger_{this};
+    poll_event event_;
+    tick_timer::time_point deadline_;
+    std::coroutine_handle<> handle_{};
+    executor* exec_{};
+    bool completed_{};
+};
+
+class semaphore_awaiter : public poll_awaiter<semaphore_awaiter>
+{
+  public:
+    static constexpr bool check_after_submit = false;
+
+    semaphore_awaiter(::k_sem& sem, tick_timer::time_point deadline)
+        : poll_awaiter(sem, deadline), sem_(sem)
+    {}
+    bool try_complete() { return acquired_ = (::k_sem_take(&sem_, K_NO_WAIT) == 0); }
+    bool await_resume() const { return acquired_; }
+
+  private:
+    ::k_sem& sem_;
+    bool acquired_{};
+};
+
+template <typename T>
+class message_awaiter : public poll_awaiter<message_awaiter<T>>
+{
+  public:
+    static constexpr bool check_after_submit = false;
+
+    message_awaiter(message_queue<T>& msgq, tick_timer::time_point deadline)
+        : poll_awaiter<message_awaiter<T>>(msgq, deadline), msgq_(msgq)
+    {}
+    bool try_complete()
+    {
+        msg_.emplace();
+        if (!msgq_.try_get(*msg_))
+        {
+            msg_.reset();
+        }
+        return msg_.has_value();
+    }
+    std::optional<T> await_resume() const { return msg_; }
+
+  private:
+    message_queue<T>& msgq_;
+    std::optional<T> msg_{};
+};
+
+class signal_awaiter : public poll_awaiter<signal_awaiter>
+{
+  public:
+    static constexpr bool check_after_submit = false;
+
+    signal_awaiter(signal& sig, tick_timer::time_point deadline)
+        : poll_awaiter(sig, deadline), signal_(sig)
+    {}
+    bool try_complete()
+    {
+        result_ = signal_.check();
+        if (result_.has_value())
+        {
+            signal_.reset();
+        }
+        return result_.has_value();
+    }
+    std::optional<int> await_resume() const { return result_; }
+
+  private:
+    signal& signal_;
+    std::optional<int> result_{};
+};
+
+#ifdef CONFIG_ZEPHYR_MCPP_EVENT_GROUP_POLL
+class event_group_awaiter : public poll_awaiter<event_group_awaiter>
+{
+  public:
+    static constexpr bool check_after_submit = true;
+
+    event_group_awaiter(event_group& group, zephyr::events flags,
+                        tick_timer::time_point deadline)
+        : poll_awaiter(group.updated(), deadline), group_(group), flags_(flags)
+    {}
+    bool try_complete() { return (result_ = group_.wait_any_for(flags_, tick_timer::duration{0})); }
+    zephyr::events await_resume() const { return result_; }
+
+  private:
+    event_group& group_;
+    zephyr::events flags_;
+    zephyr::events result_{};
+};
+#endif // CONFIG_ZEPHYR_MCPP_EVENT_GROUP_POLL
+
+class sleep_awaiter : public resumable
+{
+  public:
+    explicit sleep_awaiter(tick_timer::time_point deadline) : deadline_(deadline) {}
+    sleep_awaiter(const sleep_awaiter&) = delete;
+    sleep_awaiter& operator=(const sleep_awaiter&) = delete;
+
+    bool await_ready() const { return expired(deadline_); }
+    void await_suspend(std::coroutine_handle<task::promise_type> h)
+    {
+        handle_ = h;
+        exec_ = h.promise().exec;
+        on_ready = &ready;
+        trigger_.work.schedule_to(exec_->queue(), remaining(deadline_));
+    }
+    void await_resume() const {}
+
+  private:
+    static void elapsed(work_delayable* w)
+    {
+        auto* self = CONTAINER_OF(w, trigger, work)->owner;
+        self->exec_->post(*self);
+    }
+    static void ready(resumable* r) { static_cast<sleep_awaiter*>(r)->handle_.resume(); }
+
+    struct trigger
+    {
+        explicit trigger(sleep_awaiter* owner) : work(&elapsed), owner(owner) {}
+        work_delayable work;
+        sleep_awaiter* owner;
+    };
+
+    trigger trigger_{this};
+    tick_timer::time_point deadline_;
+    std::coroutine_handle<> handle_{};
+    executor* exec_{};
+};
+
+template <class Awaiter>
+struct value_awaiter : public Awaiter
+{
+    using Awaiter::Awaiter;
+    auto await_resume() const { return *Awaiter::await_resume(); }
+};
+
+struct acquire_awaiter : public semaphore_awaiter
+{
+    using semaphore_awaiter::semaphore_awaiter;
+    void await_resume() const {}
+};
+} // namespace detail
+
+/// @brief  Awaitable counterparts of the blocking calls, to be used in @ref task coroutines.
+///         Instead of blocking the thread, they suspend the coroutine, which is resumed
+///         on its @ref executor once the wait is over.
+namespace async
+{
+/// @brief  Suspends the task until the semaphore is acquired.
+inline detail::acquire_awaiter acquire(::k_sem& sem)
+{
+    return detail::acquire_awaiter(sem, tick_timer::time_point::max());
+}
+
+/// @brief  Suspends the task until the semaphore is acquired, or the duration elapses.
+/// @return co_await yields true if the semaphore was acquired, false if timed out
+template <class Rep, class Period>
+inline detail::semaphore_awaiter try_acquire_for(::k_sem& sem,
+                                                 const std::chrono::duration<Rep, Period>& rel_time)
+{
+    return detail::semaphore_awaiter(sem, detail::to_deadline(rel_time));
+}
+
+/// @brief  Suspends the task until the semaphore is acquired, or the deadline passes.
+/// @return co_await yields true if the semaphore was acquired, false if timed out
+template <class Clock, class Duration>
+inline detail::semaphore_awaiter
+try_acquire_until(::k_sem& sem, const std::chrono::time_point<Clock, Duration>& abs_time)
+{
+    return detail::semaphore_awaiter(sem, detail::to_deadline(abs_time));
+}
+
+/// @brief  Suspends the task until a message is received.
+/// @return co_await yields the received message
+template <typename T>
+inline detail::value_awaiter<detail::message_awaiter<T>> get(message_queue<T>& msgq)
+{
+    return detail::value_awaiter<detail::message_awaiter<T>>(msgq, tick_timer::time_point::max());
+}
+
+/// @brief  Suspends the task until a message is received, or the duration elapses.
+/// @return co_await yields the received message, or empty if timed out
+template <typename T, class Rep, class Period>
+inline detail::message_awaiter<T> try_get_for(message_queue<T>& msgq,
+                                              const std::chrono::duration<Rep, Period>& rel_time)
+{
+    return detail::message_awaiter<T>(msgq, detail::to_deadline(rel_time));
+}
+
+/// @brief  Suspends the task until a message is received, or the deadline passes.
+/// @return co_await yields the received message, or empty if timed out
+template <typename T, class Clock, class Duration>
+inline detail::message_awaiter<T>
+try_get_until(message_queue<T>& msgq, const std::chrono::time_point<Clock, Duration>& abs_time)
+{
+    return detail::message_awaiter<T>(msgq, detail::to_deadline(abs_time));
+}
+
+/// @brief  Suspends the task until the signal is raised, then resets it.
+/// @return co_await yields the signal's result value
+inline detail::value_awaiter<detail::signal_awaiter> wait(signal& sig)
+{
+    return detail::value_awaiter<detail::signal_awaiter>(sig, tick_timer::time_point::max());
+}
+
+/// @brief  Suspends the task until the signal is raised (then resets it),
+///         or the duration elapses.
+/// @return co_await yields the signal's result value, or empty if timed out
+template <class Rep, class Period>
+inline detail::signal_awaiter try_wait_for(signal& sig,
+                                           const std::chrono::duration<Rep, Period>& rel_time)
+{
+    return detail::signal_awaiter(sig, detail::to_deadline(rel_time));
+}
+
+/// @brief  Suspends the task until the signal is raised (then resets it),
+///         or the deadline passes.
+/// @return co_await yields the signal's result value, or empty if timed out
+template <class Clock, class Duration>
+inline detail::signal_awaiter
+try_wait_until(signal& sig, const std::chrono::time_point<Clock, Duration>& abs_time)
+{
+    return detail::signal_awaiter(sig, detail::to_deadline(abs_time));
+}
+
+#ifdef CONFIG_ZEPHYR_MCPP_EVENT_GROUP_POLL
+/// @brief  Suspends the task until any of the provided flags is raised.
+///         When a flag resumes the task, it will be cleared.
+/// @return co_await yields the raised flag(s) that caused the activation
+inline detail::event_group_awaiter wait_any(event_group& group, zephyr::events flags)
+{
+    return detail::event_group_awaiter(group, flags, tick_timer::time_point::max());
+}
+
+/// @brief  Suspends the task until any of the provided flags is raised,
+///         or the duration elapses. When a flag resumes the task, it will be cleared.
+/// @return co_await yields the raised flag(s) that caused the activation, or 0 if timed out
+template <class Rep, class Period>
+inline detail::event_group_awaiter
+wait_any_for(event_group& group, zephyr::events flags,
+             const std::chrono::duration<Rep, Period>& rel_time)
+{
+    return detail::event_group_awaiter(group, flags, detail::to_deadline(rel_time));
+}
+
+/// @brief  Suspends the task until any of the provided flags is raised,
+///         or the deadline passes. When a flag resumes the task, it will be cleared.
+/// @return co_await yields the raised flag(s) that caused the activation, or 0 if timed out
+template <class Clock, class Duration>
+inline detail::event_group_awaiter
+wait_any_until(event_group& group, zephyr::events flags,
+               const std::chrono::time_point<Clock, Duration>& abs_time)
+{
+    return detail::event_group_awaiter(group, flags, detail::to_deadline(abs_time));
+}
+#endif // CONFIG_ZEPHYR_MCPP_EVENT_GROUP_POLL
+
+/// @brief  Suspends the task for the given duration.
+template <class Rep, class Period>
+inline detail::sleep_awaiter sleep_for(const std::chrono::duration<Rep, Period>& rel_time)
+{
+    return detail::sleep_awaiter(detail::to_deadline(rel_time));
+}
+
+/// @brief  Suspends the task until the deadline passes.
+template <class Clock, class Duration>
+inline detail::sleep_awaiter sleep_until(const std::chrono::time_point<Clock, Duration>& abs_time)
+{
+    return detail::sleep_awaiter(detail::to_deadline(abs_time));
+}
+
+} // namespace async
+} // namespace zephyr
@@ -1,32 +1,115 @@
 // SPDX-License-Identifier: Apache-2.0
 #pragma once
+#include "zephyr/stats.hpp"
 #include "zephyr/tick_timer.hpp"
 #include <zephyr/spinlock.h>
 
 namespace zephyr
 {
+#ifdef CONFIG_ZEPHYR_MCPP_STATS
+/// @brief  Spinlock that records the spinning time of its @ref critical_section users.
+class spinlock
+{
+  public:
+    spinlock() = default;
+    spinlock(const spinlock&) = delete;
+    spinlock& operator=(const spinlock&) = delete;
+
+    const wait_stats& stats() const { return stats_; }
+    wait_stats& stats() { return stats_; }
+
+  private:
+    friend class critical_section;
+
+    ::k_spinlock lock_{};
+    wait_stats stats_{wait_stats::object_kind::spinlock, this};
+};
+#else
 using spinlock = ::k_spinlock;
+#endif
+
+/// @brief  The data cache line size, used to keep data written by different
+///         execution contexts apart, avoiding false sharing.
+#if defined(CONFIG_DCACHE_LINE_SIZE) && (CONFIG_DCACHE_LINE_SIZE > 0)
+inline constexpr std::size_t cache_line_size = CONFIG_DCACHE_LINE_SIZE;
+#else
+inline constexpr std::size_t cache_line_size = 64;
+#endif
 
 class critical_section
 {
   public:
+#ifdef CONFIG_ZEPHYR_MCPP_STATS
+    critical_section(spinlock& lock) : lock_(lock.lock_)
+    {
+        const wait_stats::stopwatch sw;
+        restore_ = ::k_spin_lock(&lock_);
+        lock.stats_.record(sw.elapsed(), true);
+    }
+#else
     critical_section(spinlock& lock) : lock_(lock) { restore_ = ::k_spin_lock(&lock_); }
+#endif
     ~critical_section() { ::k_spin_unlock(&lock_, restore_); }
 
   private:
-    spinlock& lock_;
+    ::k_spinlock& lock_;
     ::k_spinlock_key_t restore_{};
 };
 
+/// @brief  Prevents the current thread from being preempted by other threads
+///         while in scope, interrupts remain enabled. It's a no-op in ISR context,
+///         where no rescheduling happens until the ISR returns anyway,
+///         and in user mode threads, which aren't allowed to lock the scheduler.
+class scheduler_lock
+{
+  public:
+#ifdef CONFIG_USERSPACE
+    scheduler_lock() : locked_(!::k_is_in_isr() and !::k_is_user_context())
+#else
+    scheduler_lock() : locked_(!::k_is_in_isr())
+#endif
+    {
+        if (locked_)
+        {
+            ::k_sched_lock();
+        }
+    }
+    ~scheduler_lock()
+    {
+        if (locked_)
+        {
+            ::k_sched_unlock();
+        }
+    }
+    scheduler_lock(const scheduler_lock&) = delete;
+    scheduler_lock& operator=(const scheduler_lock&) = delete;
+
+  private:
+    bool locked_;
+};
+
 namespace this_cpu
 {
 /// @brief  Determines if the current execution context is inside
 ///         an interrupt service routine.
 /// @return true if the current execution context is ISR, false otherwise
-bool is_in_isr()
+inline bool is_in_isr()
 {
     return ::k_is_in_isr();
 }
 
+/// @brief  Determines the index of the CPU executing the caller.
+///         Unless interrupts or the scheduler are locked, a thread may migrate
+///         to another CPU right after the call.
+/// @return the current CPU index, below CONFIG_MP_MAX_NUM_CPUS
+inline unsigned id()
+{
+#ifdef CONFIG_SMP
+    return ::arch_curr_cpu()->id;
+#else
+    return 0;
+#endif
+}
+
 } // namespace this_cpu
 } // namespace zephyr
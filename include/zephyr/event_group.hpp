@@ -1,5 +1,7 @@
 // SPDX-License-Identifier: Apache-2.0
 #pragma once
+#include "zephyr/static_init.hpp"
+#include "zephyr/stats.hpp"
 #include "zephyr/tick_timer.hpp"
 
 namespace zephyr
@@ -40,12 +42,31 @@ struct event_group final : public ::k_event
     event_group(const event_group&) = delete;
     event_group& operator=(const event_group&) = delete;
 
-    explicit event_group() { ::k_event_init(this); }
+    explicit event_group()
+    {
+        ::k_event_init(this);
+#ifdef CONFIG_ZEPHYR_MCPP_EVENT_GROUP_POLL
+        ::k_poll_signal_init(&updated_);
+#endif
+    }
+
+    /// @brief  Initializes the event group at compile time, see @ref ZEPHYR_EVENT_GROUP_DEFINE.
+    ZEPHYR_MCPP_STATIC_CONSTEXPR explicit event_group(static_init_t)
+        : ::k_event Z_EVENT_INITIALIZER((*this))
+#ifdef CONFIG_ZEPHYR_MCPP_EVENT_GROUP_POLL
+          ,
+          updated_ K_POLL_SIGNAL_INITIALIZER(updated_)
+#endif
+    {
+#if !defined(CONFIG_ZEPHYR_MCPP_STATS) && !defined(CONFIG_ZEPHYR_MCPP_EVENT_GROUP_POLL)
+        static_assert(detail::iterable_as<::k_event, event_group>);
+#endif
+    }
 
     /// @brief  Sets the provided flags in the condition.
     /// @param  flags: the flags to activate
     /// @remark Thread and ISR context callable
-    zephyr::events set(zephyr::events flags) { return ::k_event_post(this, flags); }
+    zephyr::events set(zephyr::events flags) { return notify(::k_event_post(this, flags)); }
 
     /// @brief  Removes the provided flags from the condition.
     /// @param  flags: the flags to deactivate
@@ -58,7 +79,7 @@ struct event_group final : public ::k_event
     /// @remark Thread and ISR context callable
     zephyr::events modify(zephyr::events flags, zephyr::events mask)
     {
-        return ::k_event_set_masked(this, flags, mask);
+        return notify(::k_event_set_masked(this, flags, mask));
     }
 
     /// @brief  Reads the current flags status.
@@ -76,7 +97,8 @@ struct event_group final : public ::k_event
     zephyr::events wait_any_for(zephyr::events flags,
                                 const std::chrono::duration<Rep, Period>& rel_time)
     {
-        return ::k_event_wait_safe(this, flags, false, to_timeout(rel_time));
+        const k_timeout_t timeout = to_timeout(rel_time);
+        return measured([&] { return ::k_event_wait_safe(this, flags, false, timeout); });
     }
 
     /// @brief  Blocks the current thread until any of the provided flags is raised.
@@ -89,7 +111,8 @@ struct event_group final : public ::k_event
     zephyr::events wait_any_until(zephyr::events flags,
                                   const std::chrono::time_point<Clock, Duration>& abs_time)
     {
-        return wait_any_for(flags, duration_until(abs_time));
+        const k_timeout_t timeout = timeout_until(abs_time);
+        return measured([&] { return ::k_event_wait_safe(this, flags, false, timeout); });
     }
 
     zephyr::events wait_any(zephyr::events flags) { return wait_any_for(flags, infinity); }
@@ -104,7 +127,8 @@ struct event_group final : public ::k_event
     zephyr::events wait_all_for(zephyr::events flags,
                                 const std::chrono::duration<Rep, Period>& rel_time)
     {
-        return ::k_event_wait_all_safe(this, flags, false, to_timeout(rel_time));
+        const k_timeout_t timeout = to_timeout(rel_time);
+        return measured([&] { return ::k_event_wait_all_safe(this, flags, false, timeout); });
     }
 
     /// @brief  Blocks the current thread until all of the provided flags are raised.
@@ -117,7 +141,8 @@ struct event_group final : public ::k_event
     zephyr::events wait_all_until(zephyr::events flags,
                                   const std::chrono::time_point<Clock, Duration>& abs_time)
     {
-        return wait_all_for(flags, duration_until(abs_time));
+        const k_timeout_t timeout = timeout_until(abs_time);
+        return measured([&] { return ::k_event_wait_all_safe(this, flags, false, timeout); });
     }
 
     zephyr::events wait_all(zephyr::events flags) { return wait_all_for(flags, infinity); }
@@ -132,7 +157,8 @@ struct event_group final : public ::k_event
     zephyr::events shared_wait_any_for(zephyr::events flags,
                                        const std::chrono::duration<Rep, Period>& rel_time)
     {
-        return ::k_event_wait(this, flags, false, to_timeout(rel_time));
+        const k_timeout_t timeout = to_timeout(rel_time);
+        return measured([&] { return ::k_event_wait(this, flags, false, timeout); });
     }
 
     /// @brief  Blocks the current thread until any of the provided flags is raised.
@@ -145,7 +171,8 @@ struct event_group final : public ::k_event
     zephyr::events shared_wait_any_until(zephyr::events flags,
                                          const std::chrono::time_point<Clock, Duration>& abs_time)
     {
-        return shared_wait_any_for(flags, duration_until(abs_time));
+        const k_timeout_t timeout = timeout_until(abs_time);
+        return measured([&] { return ::k_event_wait(this, flags, false, timeout); });
     }
 
     zephyr::events shared_wait_any(zephyr::events flags)
@@ -163,7 +190,8 @@ struct event_group final : public ::k_event
     zephyr::events shared_wait_all_for(zephyr::events flags,
                                        const std::chrono::duration<Rep, Period>& rel_time)
     {
-        return ::k_event_wait_all(this, flags, false, to_timeout(rel_time));
+        const k_timeout_t timeout = to_timeout(rel_time);
+        return measured([&] { return ::k_event_wait_all(this, flags, false, timeout); });
     }
 
     /// @brief  Blocks the current thread until all of the provided flags are raised.
@@ -176,13 +204,75 @@ struct event_group final : public ::k_event
     zephyr::events shared_wait_all_until(zephyr::events flags,
                                          const std::chrono::time_point<Clock, Duration>& abs_time)
     {
-        return shared_wait_all_for(flags, duration_until(abs_time));
+        const k_timeout_t timeout = timeout_until(abs_time);
+        return measured([&] { return ::k_event_wait_all(this, flags, false, timeout); });
     }
 
     zephyr::events shared_wait_all(zephyr::events flags)
     {
         return shared_wait_all_for(flags, infinity);
     }
+
+#ifdef CONFIG_ZEPHYR_MCPP_STATS
+    const wait_stats& stats() const { return stats_; }
+    wait_stats& stats() { return stats_; }
+
+#endif
+#ifdef CONFIG_ZEPHYR_MCPP_EVENT_GROUP_POLL
+    /// @brief  The signal that is raised (and immediately reset) on every flag update,
+    ///         to construct a @ref poll_event from. The kernel can't poll the flags
+    ///         themselves, so check them after the poll registration.
+    ::k_poll_signal& updated() { return updated_; }
+
+  private:
+    zephyr::events notify(zephyr::events prev)
+    {
+        // held off while a wait_any() caller is between checking the flags and polling
+        const unsigned int key = ::irq_lock();
+        ::k_poll_signal_raise(&updated_, 0);
+        ::k_poll_signal_reset(&updated_);
+        ::irq_unlock(key);
+        return prev;
+    }
+
+    ::k_poll_signal updated_;
+#else
+  private:
+    static zephyr::events notify(zephyr::events prev) { return prev; }
+#endif
+
+#ifdef CONFIG_ZEPHYR_MCPP_STATS
+    template <typename F>
+    zephyr::events measured(F&& wait)
+    {
+        const wait_stats::stopwatch sw;
+        const zephyr::events result = wait();
+        stats_.record(sw.elapsed(), result != 0);
+        return result;
+    }
+
+    wait_stats stats_{wait_stats::object_kind::event_group, this};
+#else
+    template <typename F>
+    static zephyr::events measured(F&& wait)
+    {
+        return wait();
+    }
+#endif
 };
 
 } // namespace zephyr
+
+/// @brief  Defines an event_group that is initialized at compile time, and (unless it has
+///         the poll signal member) placed in the kernel's event section, like K_EVENT_DEFINE.
+/// @param  name: the name of the event group variable
+#ifdef CONFIG_ZEPHYR_MCPP_EVENT_GROUP_POLL
+#define ZEPHYR_EVENT_GROUP_DEFINE(name)                                                            \
+    ZEPHYR_MCPP_STATIC_CONSTINIT ::zephyr::event_group name{::zephyr::static_init}
+#else
+#define ZEPHYR_EVENT_GROUP_DEFINE(name)                                                            \
+    ZEPHYR_MCPP_STATIC_OBJECT(k_event, ::zephyr::event_group, name)                                \
+    {                                                                                              \
+        ::zephyr::static_init                                                                      \
+    }
+#endif
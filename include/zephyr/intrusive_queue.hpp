@@ -0,0 +1,169 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+#include <span>
+#include <type_traits>
+#include "zephyr/tick_timer.hpp"
+
+namespace zephyr
+{
+/// @brief  The word that the kernel links the items of an @ref intrusive_fifo or
+///         @ref intrusive_lifo with. Derive the item type from it.
+struct queue_node
+{
+    void* reserved{};
+};
+
+namespace detail
+{
+template <typename T>
+inline void* to_node(T& item)
+{
+    static_assert(std::is_base_of_v<queue_node, T>, "T must derive from queue_node");
+    return static_cast<void*>(static_cast<queue_node*>(&item));
+}
+
+template <typename T>
+inline T* from_node(void* node)
+{
+    return node != nullptr ? static_cast<T*>(static_cast<queue_node*>(node)) : nullptr;
+}
+} // namespace detail
+
+/// @brief  First in, first out queue of T objects, that passes the object pointers
+///         without copying the objects. The queued objects are owned by the queue,
+///         they must not be accessed, destroyed or queued again until they are received.
+template <typename T>
+struct intrusive_fifo final : public ::k_fifo
+{
+    intrusive_fifo(const intrusive_fifo&) = delete;
+    intrusive_fifo& operator=(const intrusive_fifo&) = delete;
+
+    intrusive_fifo() { k_fifo_init(this); }
+
+    /// @brief  Appends the object to the queue.
+    /// @param  item: the object to pass
+    /// @remark Thread and ISR context callable
+    void post(T& item) { k_fifo_put(this, detail::to_node(item)); }
+
+    /// @brief  Appends the objects to the queue at once, in order.
+    /// @param  items: the objects to pass, the span itself isn't retained
+    /// @remark Thread and ISR context callable
+    void post_n(std::span<T* const> items)
+    {
+        if (items.empty())
+        {
+            return;
+        }
+        for (std::size_t i = 1; i < items.size(); ++i)
+        {
+            static_cast<queue_node*>(items[i - 1])->reserved = detail::to_node(*items[i]);
+        }
+        static_cast<queue_node*>(items.back())->reserved = nullptr;
+        k_fifo_put_list(this, detail::to_node(*items.front()), detail::to_node(*items.back()));
+    }
+
+    /// @brief  Appends the list of objects (linked by their @ref queue_node, terminated by
+    ///         nullptr) to the queue at once.
+    /// @param  head: the first object of the list
+    /// @param  tail: the last object of the list
+    /// @remark Thread and ISR context callable
+    void put_list(T& head, T& tail)
+    {
+        k_fifo_put_list(this, detail::to_node(head), detail::to_node(tail));
+    }
+
+    /// @brief  Removes the first object from the queue, blocking until one is available.
+    /// @return the received object
+    /// @remark Thread context callable
+    T* get() { return receive(K_FOREVER); }
+
+    /// @brief  Removes the first object from the queue, if one is available.
+    /// @return the received object, or nullptr if the queue is empty
+    /// @remark Thread and ISR context callable
+    T* try_get() { return receive(K_NO_WAIT); }
+
+    /// @brief  Removes the first object from the queue.
+    /// @param  rel_time: duration to wait for an object
+    /// @return the received object, or nullptr if timed out
+    /// @remark Thread context callable
+    template <class Rep, class Period>
+    T* try_get_for(const std::chrono::duration<Rep, Period>& rel_time)
+    {
+        return receive(to_timeout(rel_time));
+    }
+
+    /// @brief  Removes the first object from the queue.
+    /// @param  abs_time: deadline to wait for an object
+    /// @return the received object, or nullptr if timed out
+    /// @remark Thread context callable
+    template <class Clock, class Duration>
+    T* try_get_until(const std::chrono::time_point<Clock, Duration>& abs_time)
+    {
+        return receive(timeout_until(abs_time));
+    }
+
+    /// @brief  Accesses the first object without removing it.
+    T* front() { return detail::from_node<T>(k_fifo_peek_head(this)); }
+    /// @brief  Accesses the last object without removing it.
+    T* back() { return detail::from_node<T>(k_fifo_peek_tail(this)); }
+
+    bool empty() { return k_fifo_is_empty(this) != 0; }
+
+    /// @brief  Makes the first thread waiting in a get call return nullptr.
+    void cancel_wait() { k_fifo_cancel_wait(this); }
+
+  private:
+    T* receive(k_timeout_t timeout) { return detail::from_node<T>(k_fifo_get(this, timeout)); }
+};
+
+/// @brief  Last in, first out queue of T objects, that passes the object pointers
+///         without copying the objects. The queued objects are owned by the queue,
+///         they must not be accessed, destroyed or queued again until they are received.
+template <typename T>
+struct intrusive_lifo final : public ::k_lifo
+{
+    intrusive_lifo(const intrusive_lifo&) = delete;
+    intrusive_lifo& operator=(const intrusive_lifo&) = delete;
+
+    intrusive_lifo() { k_lifo_init(this); }
+
+    /// @brief  Pushes the object to the queue.
+    /// @param  item: the object to pass
+    /// @remark Thread and ISR context callable
+    void post(T& item) { k_lifo_put(this, detail::to_node(item)); }
+
+    /// @brief  Removes the last pushed object from the queue, blocking until one is available.
+    /// @return the received object
+    /// @remark Thread context callable
+    T* get() { return receive(K_FOREVER); }
+
+    /// @brief  Removes the last pushed object from the queue, if one is available.
+    /// @return the received object, or nullptr if the queue is empty
+    /// @remark Thread and ISR context callable
+    T* try_get() { return receive(K_NO_WAIT); }
+
+    /// @brief  Removes the last pushed object from the queue.
+    /// @param  rel_time: duration to wait for an object
+    /// @return the received object, or nullptr if timed out
+    /// @remark Thread context callable
+    template <class Rep, class Period>
+    T* try_get_for(const std::chrono::duration<Rep, Period>& rel_time)
+    {
+        return receive(to_timeout(rel_time));
+    }
+
+    /// @brief  Removes the last pushed object from the queue.
+    /// @param  abs_time: deadline to wait for an object
+    /// @return the received object, or nullptr if timed out
+    /// @remark Thread context callable
+    template <class Clock, class Duration>
+    T* try_get_until(const std::chrono::time_point<Clock, Duration>& abs_time)
+    {
+        return receive(timeout_until(abs_time));
+    }
+
+  private:
+    T* receive(k_timeout_t timeout) { return detail::from_node<T>(k_lifo_get(this, timeout)); }
+};
+
+} // namespace zephyr
@@ -0,0 +1,139 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <span>
+#include "zephyr/tick_timer.hpp"
+
+namespace zephyr
+{
+template <typename T>
+struct memory_pool;
+
+/// @brief  Returns the object to its @ref memory_pool when the owning @ref pool_ptr
+///         goes out of scope.
+template <typename T>
+struct pool_deleter
+{
+    memory_pool<T>* pool{};
+
+    void operator()(T* ptr) const { pool->deallocate(ptr); }
+};
+
+/// @brief  Owning handle of an object allocated from a @ref memory_pool.
+///         To pass the object through a @ref message_queue, post the raw pointer
+///         from @ref pool_ptr::release, and @ref memory_pool::adopt it on the receiving side.
+template <typename T>
+using pool_ptr = std::unique_ptr<T, pool_deleter<T>>;
+
+/// @brief  Fixed-size block allocator of T objects, with O(1) allocation and deallocation.
+///         Allocations block the caller (up to a chosen time) while the pool is depleted.
+template <typename T>
+struct memory_pool : public ::k_mem_slab
+{
+    memory_pool(const memory_pool&) = delete;
+    memory_pool& operator=(const memory_pool&) = delete;
+
+    static constexpr std::size_t block_alignment = std::max(alignof(T), sizeof(void*));
+    static constexpr std::size_t block_size =
+        (sizeof(T) + block_alignment - 1) / block_alignment * block_alignment;
+
+    /// @brief  Allocates and constructs an object, blocking until a block is available.
+    /// @param  args: the object's constructor arguments
+    /// @return the owning handle of the object
+    /// @remark Thread context callable
+    template <typename... Args>
+    pool_ptr<T> allocate(Args&&... args)
+    {
+        return try_allocate_for(infinity, std::forward<Args>(args)...);
+    }
+
+    /// @brief  Allocates and constructs an object, if a block is available.
+    /// @param  args: the object's constructor arguments
+    /// @return the owning handle of the object, or empty if the pool is depleted
+    /// @remark Thread and ISR context callable
+    template <typename... Args>
+    pool_ptr<T> try_allocate(Args&&... args)
+    {
+        return try_allocate_for(tick_timer::duration{0}, std::forward<Args>(args)...);
+    }
+
+    /// @brief  Allocates and constructs an object.
+    /// @param  rel_time: duration to wait for a free block
+    /// @param  args: the object's constructor arguments
+    /// @return the owning handle of the object, or empty if timed out
+    /// @remark Thread context callable
+    template <class Rep, class Period, typename... Args>
+    pool_ptr<T> try_allocate_for(const std::chrono::duration<Rep, Period>& rel_time,
+                                 Args&&... args)
+    {
+        return allocate_with(to_timeout(rel_time), std::forward<Args>(args)...);
+    }
+
+    /// @brief  Allocates and constructs an object.
+    /// @param  abs_time: deadline to wait for a free block
+    /// @param  args: the object's constructor arguments
+    /// @return the owning handle of the object, or empty if timed out
+    /// @remark Thread context callable
+    template <class Clock, class Duration, typename... Args>
+    pool_ptr<T> try_allocate_until(const std::chrono::time_point<Clock, Duration>& abs_time,
+                                   Args&&... args)
+    {
+        return allocate_with(timeout_until(abs_time), std::forward<Args>(args)...);
+    }
+
+    /// @brief  Takes back ownership of an object previously released from a @ref pool_ptr
+    ///         of this pool.
+    /// @param  ptr: the released object
+    /// @return the owning handle of the object
+    pool_ptr<T> adopt(T* ptr) { return pool_ptr<T>(ptr, pool_deleter<T>{this}); }
+
+    /// @brief  Destroys the object and returns its block to the pool.
+    ///         Prefer letting the owning @ref pool_ptr do this.
+    /// @param  ptr: the object to free
+    /// @remark Thread and ISR context callable
+    void deallocate(T* ptr)
+    {
+        ptr->~T();
+        ::k_mem_slab_free(this, static_cast<void*>(ptr));
+    }
+
+    std::size_t size() const { return ::k_mem_slab_num_used_get(const_cast<memory_pool*>(this)); }
+    std::size_t free_space() const
+    {
+        return ::k_mem_slab_num_free_get(const_cast<memory_pool*>(this));
+    }
+    std::size_t max_size() const { return size() + free_space(); }
+    bool empty() const { return size() == 0; }
+    bool full() const { return free_space() == 0; }
+
+  protected:
+    memory_pool(const std::span<char>& buffer)
+    {
+        ::k_mem_slab_init(this, buffer.data(), block_size, buffer.size() / block_size);
+    }
+
+  private:
+    template <typename... Args>
+    pool_ptr<T> allocate_with(k_timeout_t timeout, Args&&... args)
+    {
+        void* block;
+        if (::k_mem_slab_alloc(this, &block, timeout) != 0)
+        {
+            return pool_ptr<T>(nullptr, pool_deleter<T>{this});
+        }
+        return adopt(new (block) T(std::forward<Args>(args)...));
+    }
+};
+
+template <typename T, std::size_t SIZE>
+struct memory_pool_instance final : public memory_pool<T>
+{
+    memory_pool_instance() : memory_pool<T>(slab_buffer_) {}
+
+  private:
+    char slab_buffer_[SIZE * memory_pool<T>::block_size] alignas(memory_pool<T>::block_alignment);
+};
+
+} // namespace zephyr
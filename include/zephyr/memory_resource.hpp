@@ -0,0 +1,317 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory_resource>
+#include <new>
+#include <span>
+#include <zephyr/sys/mem_blocks.h>
+#include "zephyr/tick_timer.hpp"
+
+namespace zephyr
+{
+/// @brief  Usage statistics of a memory resource, in bytes.
+class resource_stats
+{
+  public:
+    /// @brief  The number of bytes currently allocated.
+    std::size_t in_use() const { return in_use_.load(std::memory_order_relaxed); }
+    /// @brief  The highest number of bytes that were allocated at once.
+    std::size_t peak() const { return peak_.load(std::memory_order_relaxed); }
+    /// @brief  The number of successful allocations.
+    std::size_t allocations() const { return allocations_.load(std::memory_order_relaxed); }
+    /// @brief  The number of allocations that failed.
+    std::size_t failures() const { return failures_.load(std::memory_order_relaxed); }
+
+    /// @brief  Restarts the peak usage and the counters, the peak from the current usage.
+    void reset()
+    {
+        peak_.store(in_use(), std::memory_order_relaxed);
+        allocations_.store(0, std::memory_order_relaxed);
+        failures_.store(0, std::memory_order_relaxed);
+    }
+
+    void record_allocation(std::size_t bytes)
+    {
+        allocations_.fetch_add(1, std::memory_order_relaxed);
+        const std::size_t level = in_use_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        std::size_t high = peak();
+        while ((level > high) and
+               !peak_.compare_exchange_weak(high, level, std::memory_order_relaxed))
+        {
+        }
+    }
+    void record_deallocation(std::size_t bytes)
+    {
+        in_use_.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+    void record_failure() { failures_.fetch_add(1, std::memory_order_relaxed); }
+
+  private:
+    std::atomic<std::size_t> in_use_{};
+    std::atomic<std::size_t> peak_{};
+    std::atomic<std::size_t> allocations_{};
+    std::atomic<std::size_t> failures_{};
+};
+
+namespace detail
+{
+/// @brief  Reports the failure of std::pmr::memory_resource::allocate(), which must not
+///         return null: throws std::bad_alloc, or terminates when exceptions are disabled.
+[[noreturn]] inline void bad_alloc()
+{
+#ifdef __cpp_exceptions
+    throw std::bad_alloc();
+#else
+    std::terminate();
+#endif
+}
+} // namespace detail
+
+/// @brief  Memory resource allocating from a kernel heap, which bounds the memory use
+///         of the containers that it's given to, and returns the memory to the heap
+///         when they are done.
+///         The allocations wait up to the configured time for another thread to free enough
+///         memory, and fail (see @ref detail::bad_alloc) afterwards. Allocating with a timeout
+///         that reports the failure by returning null is possible with @ref try_allocate_for.
+class heap_resource : public std::pmr::memory_resource
+{
+  public:
+    /// @brief  Allocates from an existing heap, e.g. one defined by K_HEAP_DEFINE.
+    /// @param  heap: the kernel heap
+    /// @param  wait_time: the duration that the allocations wait for free memory
+    template <class Rep = tick_timer::rep, class Period = tick_timer::period>
+    explicit heap_resource(
+        ::k_heap& heap,
+        const std::chrono::duration<Rep, Period>& wait_time = tick_timer::duration{0})
+        : heap_(&heap), wait_time_(to_timeout(wait_time))
+    {
+    }
+
+    /// @brief  Allocates memory, unless the heap runs out of free memory for the duration.
+    /// @param  bytes: the size of the allocation
+    /// @param  rel_time: duration to wait for free memory
+    /// @param  alignment: the alignment of the allocation, a power of two
+    /// @return the allocated memory, or null if timed out
+    /// @remark Thread context callable, ISR context callable with zero duration
+    template <class Rep, class Period>
+    void* try_allocate_for(std::size_t bytes, const std::chrono::duration<Rep, Period>& rel_time,
+                           std::size_t alignment = alignof(std::max_align_t))
+    {
+        return allocate_with(bytes, alignment, to_timeout(rel_time));
+    }
+
+    /// @brief  Allocates memory, unless the heap runs out of free memory until the deadline.
+    /// @param  bytes: the size of the allocation
+    /// @param  abs_time: deadline to wait for free memory
+    /// @param  alignment: the alignment of the allocation, a power of two
+    /// @return the allocated memory, or null if timed out
+    /// @remark Thread context callable
+    template <class Clock, class Duration>
+    void* try_allocate_until(std::size_t bytes,
+                             const std::chrono::time_point<Clock, Duration>& abs_time,
+                             std::size_t alignment = alignof(std::max_align_t))
+    {
+        return allocate_with(bytes, alignment, timeout_until(abs_time));
+    }
+
+    const resource_stats& stats() const { return stats_; }
+    resource_stats& stats() { return stats_; }
+    ::k_heap& heap() { return *heap_; }
+
+  protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        void* const ptr = allocate_with(bytes, alignment, wait_time_);
+        if (ptr == nullptr)
+        {
+            detail::bad_alloc();
+        }
+        return ptr;
+    }
+
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t) override
+    {
+        ::k_heap_free(heap_, ptr);
+        stats_.record_deallocation(bytes);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+  private:
+    void* allocate_with(std::size_t bytes, std::size_t alignment, k_timeout_t timeout)
+    {
+        // the heap doesn't serve empty allocations, while memory_resource must
+        void* const ptr = ::k_heap_aligned_alloc(heap_, alignment, std::max<std::size_t>(bytes, 1),
+                                                 timeout);
+        if (ptr == nullptr)
+        {
+            stats_.record_failure();
+            return nullptr;
+        }
+        stats_.record_allocation(bytes);
+        return ptr;
+    }
+
+    ::k_heap* heap_;
+    k_timeout_t wait_time_;
+    resource_stats stats_{};
+};
+
+/// @brief  @ref heap_resource with its own heap of SIZE bytes (including the heap's overhead).
+template <std::size_t SIZE>
+class heap_resource_instance final : public heap_resource
+{
+  public:
+    template <class Rep = tick_timer::rep, class Period = tick_timer::period>
+    explicit heap_resource_instance(
+        const std::chrono::duration<Rep, Period>& wait_time = tick_timer::duration{0})
+        : heap_resource(heap_object_, wait_time)
+    {
+        ::k_heap_init(&heap_object_, heap_buffer_, SIZE);
+    }
+
+  private:
+    ::k_heap heap_object_{};
+    char heap_buffer_[SIZE] alignas(sizeof(void*));
+};
+
+/// @brief  Memory resource allocating runs of fixed-size blocks from a sys_mem_blocks
+///         allocator, in deterministic time, without the fragmentation of the block headers.
+///         Suits the containers with node sized allocations (lists, maps) when the block size
+///         matches their nodes, and is callable from ISRs.
+///         The allocations are rounded up to whole blocks, and aligned at most to the block size
+///         (and the alignment of the allocator's buffer).
+class block_resource : public std::pmr::memory_resource
+{
+  public:
+    /// @brief  Allocates from an existing block allocator, defined by SYS_MEM_BLOCKS_DEFINE.
+    /// @param  blocks: the block allocator
+    explicit block_resource(::sys_mem_blocks_t& blocks) : blocks_(&blocks) {}
+
+    std::size_t block_size() const { return std::size_t{1} << blocks_->info.blk_sz_shift; }
+
+    const resource_stats& stats() const { return stats_; }
+    resource_stats& stats() { return stats_; }
+
+  protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        void* ptr;
+        if (::sys_mem_blocks_alloc_contiguous(blocks_, blocks_of(bytes), &ptr) != 0)
+        {
+            stats_.record_failure();
+            detail::bad_alloc();
+        }
+        if (reinterpret_cast<std::uintptr_t>(ptr) % alignment != 0)
+        {
+            ::sys_mem_blocks_free_contiguous(blocks_, ptr, blocks_of(bytes));
+            stats_.record_failure();
+            detail::bad_alloc();
+        }
+        stats_.record_allocation(bytes);
+        return ptr;
+    }
+
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t) override
+    {
+        ::sys_mem_blocks_free_contiguous(blocks_, ptr, blocks_of(bytes));
+        stats_.record_deallocation(bytes);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+  private:
+    std::size_t blocks_of(std::size_t bytes) const
+    {
+        return std::max<std::size_t>((bytes + block_size() - 1) >> blocks_->info.blk_sz_shift, 1);
+    }
+
+    ::sys_mem_blocks_t* blocks_;
+    resource_stats stats_{};
+};
+
+/// @brief  Monotonic memory resource over a fixed buffer: allocations bump a pointer
+///         (lock-free, also from ISRs), deallocations are no-ops, and the whole buffer
+///         is reclaimed at once with @ref release. Suits the short-lived containers of
+///         a processing cycle, which are all discarded at its end.
+///         Unlike std::pmr::monotonic_buffer_resource, it never falls back to another resource,
+///         allocating beyond the buffer fails (see @ref detail::bad_alloc).
+class arena_resource : public std::pmr::memory_resource
+{
+  public:
+    arena_resource(const arena_resource&) = delete;
+    arena_resource& operator=(const arena_resource&) = delete;
+
+    /// @brief  Reclaims all allocations. Must not run concurrently with allocations,
+    ///         and the memory of the previous allocations must not be used afterwards.
+    void release()
+    {
+        stats_.record_deallocation(used());
+        offset_.store(0, std::memory_order_relaxed);
+    }
+
+    /// @brief  The number of bytes consumed from the buffer, including alignment padding.
+    std::size_t used() const { return offset_.load(std::memory_order_relaxed); }
+    std::size_t capacity() const { return buffer_.size(); }
+
+    const resource_stats& stats() const { return stats_; }
+    resource_stats& stats() { return stats_; }
+
+  protected:
+    explicit arena_resource(const std::span<char>& buffer) : buffer_(buffer) {}
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        const auto base = reinterpret_cast<std::uintptr_t>(buffer_.data());
+        std::size_t offset = used();
+        std::size_t end;
+        do
+        {
+            const std::size_t start = ((base + offset + alignment - 1) & ~(alignment - 1)) - base;
+            end = start + bytes;
+            if (end > buffer_.size())
+            {
+                stats_.record_failure();
+                detail::bad_alloc();
+            }
+        } while (!offset_.compare_exchange_weak(offset, end, std::memory_order_relaxed));
+        // the padding is accounted too, so that release() balances the usage
+        stats_.record_allocation(end - offset);
+        return buffer_.data() + (end - bytes);
+    }
+
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+  private:
+    std::span<char> buffer_;
+    std::atomic<std::size_t> offset_{};
+    resource_stats stats_{};
+};
+
+/// @brief  @ref arena_resource with its own buffer of SIZE bytes.
+template <std::size_t SIZE>
+class arena_resource_instance final : public arena_resource
+{
+  public:
+    arena_resource_instance() : arena_resource(arena_buffer_) {}
+
+  private:
+    char arena_buffer_[SIZE] alignas(std::max_align_t);
+};
+
+} // namespace zephyr
@@ -1,41 +1,118 @@
 // SPDX-License-Identifier: Apache-2.0
 #pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <optional>
 #include <span>
+#include <type_traits>
+#include "zephyr/cpu.hpp"
+#include "zephyr/semaphore.hpp"
+#include "zephyr/static_init.hpp"
+#include "zephyr/stats.hpp"
 #include "zephyr/tick_timer.hpp"
+#include "zephyr/trace.hpp"
 
 namespace zephyr
 {
 template <typename T>
 struct message_queue : public ::k_msgq
 {
-    void post(const T& msg) { ::k_msgq_put(this, &msg, K_FOREVER); }
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "message_queue copies messages bytewise, T must be trivially copyable");
 
-    bool try_post(const T& msg) { return ::k_msgq_put(this, &msg, K_NO_WAIT) == 0; }
+    void post(const T& msg) { put(msg, K_FOREVER); }
+
+    bool try_post(const T& msg) { return put(msg, K_NO_WAIT) == 0; }
 
     template <class Rep, class Period>
     inline bool try_post_for(const T& msg, const std::chrono::duration<Rep, Period>& rel_time)
     {
-        return ::k_msgq_put(this, &msg, to_timeout(rel_time)) == 0;
+        return put(msg, to_timeout(rel_time)) == 0;
     }
 
     template <class Clock, class Duration>
     inline bool try_post_until(const T& msg,
                                const std::chrono::time_point<Clock, Duration>& abs_time)
     {
-        return try_post_for(duration_until(abs_time));
+        return put(msg, timeout_until(abs_time)) == 0;
+    }
+
+    /// @brief  Posts all messages of the batch, blocking while the queue is full.
+    ///         The scheduler is locked meanwhile, so a woken receiver only runs
+    ///         once the batch is queued, or when the queue fills up.
+    /// @param  msgs: the messages to post, in order
+    /// @remark Thread context callable
+    void post_n(std::span<const T> msgs)
+    {
+        scheduler_lock lock;
+        for (const T& msg : msgs)
+        {
+            put(msg, K_FOREVER);
+        }
+    }
+
+    /// @brief  Posts the leading messages of the batch that fit in the queue.
+    ///         The scheduler is locked meanwhile, so a woken receiver only runs
+    ///         once the batch is queued.
+    /// @param  msgs: the messages to post, in order
+    /// @return the number of messages posted
+    /// @remark Thread and ISR context callable
+    std::size_t try_post_n(std::span<const T> msgs)
+    {
+        scheduler_lock lock;
+        std::size_t n = 0;
+        for (; (n < msgs.size()) and (put(msgs[n], K_NO_WAIT) == 0); ++n)
+        {
+        }
+        return n;
     }
 
     T get()
     {
         T msg;
-        ::k_msgq_get(this, static_cast<void*>(&msg), K_FOREVER);
+        get(msg);
         return msg;
     }
+
+    /// @brief  Receives a message straight into the provided storage,
+    ///         blocking until one is available.
+    /// @param  msg: the storage to receive into
+    /// @remark Thread context callable
+    void get(T& msg) { receive(msg, K_FOREVER); }
+
+    /// @brief  Receives a message straight into the provided storage, if one is available.
+    /// @param  msg: the storage to receive into, only written on success
+    /// @return true if a message was received, false otherwise
+    /// @remark Thread and ISR context callable
+    bool try_get(T& msg) { return receive(msg, K_NO_WAIT) == 0; }
+
+    /// @brief  Receives a message straight into the provided storage.
+    /// @param  msg: the storage to receive into, only written on success
+    /// @param  rel_time: duration to wait for a message
+    /// @return true if a message was received, false if timed out
+    /// @remark Thread context callable
+    template <class Rep, class Period>
+    bool try_get_for(T& msg, const std::chrono::duration<Rep, Period>& rel_time)
+    {
+        return receive(msg, to_timeout(rel_time)) == 0;
+    }
+
+    /// @brief  Receives a message straight into the provided storage.
+    /// @param  msg: the storage to receive into, only written on success
+    /// @param  abs_time: deadline to wait for a message
+    /// @return true if a message was received, false if timed out
+    /// @remark Thread context callable
+    template <class Clock, class Duration>
+    bool try_get_until(T& msg, const std::chrono::time_point<Clock, Duration>& abs_time)
+    {
+        return receive(msg, timeout_until(abs_time)) == 0;
+    }
+
     std::optional<T> try_get()
     {
-        std::optional<T> msg{T()};
-        if (::k_msgq_get(this, static_cast<void*>(&(*msg)), K_NO_WAIT) != 0)
+        std::optional<T> msg{std::in_place};
+        if (!try_get(*msg))
         {
             msg.reset();
         }
@@ -44,8 +121,8 @@ struct message_queue : public ::k_msgq
     template <class Rep, class Period>
     std::optional<T> try_get_for(const std::chrono::duration<Rep, Period>& rel_time)
     {
-        std::optional<T> msg{T()};
-        if (::k_msgq_get(this, static_cast<void*>(&(*msg)), to_timeout(rel_time)) != 0)
+        std::optional<T> msg{std::in_place};
+        if (!try_get_for(*msg, rel_time))
         {
             msg.reset();
         }
@@ -54,15 +131,69 @@ struct message_queue : public ::k_msgq
     template <class Clock, class Duration>
     std::optional<T> try_get_until(const std::chrono::time_point<Clock, Duration>& abs_time)
     {
-        return try_get_for(duration_until(abs_time));
+        std::optional<T> msg{std::in_place};
+        if (!try_get_until(*msg, abs_time))
+        {
+            msg.reset();
+        }
+        return msg;
+    }
+
+    /// @brief  Receives a batch of messages, blocking until at least one is available,
+    ///         then draining as many of the queued messages as the span fits.
+    /// @param  msgs: the storage to receive into
+    /// @return the number of messages received
+    /// @remark Thread context callable
+    std::size_t get_n(std::span<T> msgs) { return receive_n(msgs, K_FOREVER); }
+
+    /// @brief  Receives as many of the queued messages as the span fits, without blocking.
+    /// @param  msgs: the storage to receive into
+    /// @return the number of messages received
+    /// @remark Thread and ISR context callable
+    std::size_t try_get_n(std::span<T> msgs)
+    {
+        return receive_n(msgs, K_NO_WAIT);
+    }
+
+    /// @brief  Receives a batch of messages, waiting for at least one to become available,
+    ///         then draining as many of the queued messages as the span fits.
+    /// @param  msgs: the storage to receive into
+    /// @param  rel_time: duration to wait for the first message
+    /// @return the number of messages received, 0 if timed out
+    /// @remark Thread context callable
+    template <class Rep, class Period>
+    std::size_t try_get_n_for(std::span<T> msgs, const std::chrono::duration<Rep, Period>& rel_time)
+    {
+        return receive_n(msgs, to_timeout(rel_time));
+    }
+
+    /// @brief  Receives a batch of messages, waiting for at least one to become available,
+    ///         then draining as many of the queued messages as the span fits.
+    /// @param  msgs: the storage to receive into
+    /// @param  abs_time: deadline to wait for the first message
+    /// @return the number of messages received, 0 if timed out
+    /// @remark Thread context callable
+    template <class Clock, class Duration>
+    std::size_t try_get_n_until(std::span<T> msgs,
+                                const std::chrono::time_point<Clock, Duration>& abs_time)
+    {
+        return receive_n(msgs, timeout_until(abs_time));
     }
 
     void flush() { ::k_msgq_purge(this); }
 
+    /// @brief  Copies the first message into the provided storage, without removing it.
+    /// @param  msg: the storage to copy into, only written on success
+    /// @return true if the queue wasn't empty, false otherwise
+    bool peek(T& msg) const
+    {
+        return ::k_msgq_peek(const_cast<message_queue*>(this), static_cast<void*>(&msg)) == 0;
+    }
+
     std::optional<T> peek() const
     {
-        std::optional<T> msg{T()};
-        if (::k_msgq_peek(const_cast<message_queue*>(this), static_cast<void*>(&(*msg))) != 0)
+        std::optional<T> msg{std::in_place};
+        if (!peek(*msg))
         {
             msg.reset();
         }
@@ -85,10 +216,83 @@ struct message_queue : public ::k_msgq
 
     bool full() const { return ::k_msgq_num_free_get(const_cast<message_queue*>(this)) == 0; }
 
+#ifdef CONFIG_ZEPHYR_MCPP_STATS
+    const wait_stats& stats() const { return stats_; }
+    wait_stats& stats() { return stats_; }
+
+#endif
+    /// @brief  Initializes the queue at compile time, see @ref ZEPHYR_MESSAGE_QUEUE_DEFINE.
+    /// @param  buffer: the message storage, it must outlive the queue
+    ZEPHYR_MCPP_STATIC_CONSTEXPR message_queue(static_init_t, const std::span<char>& buffer)
+        : ::k_msgq Z_MSGQ_INITIALIZER((*this), buffer.data(), sizeof(T),
+                                      static_cast<std::uint32_t>(buffer.size() / sizeof(T)))
+    {
+#ifndef CONFIG_ZEPHYR_MCPP_STATS
+        static_assert(detail::iterable_as<::k_msgq, message_queue>);
+#endif
+    }
+
   protected:
     message_queue(const std::span<char>& buffer)
     {
-        ::k_msgq_init(this, buffer.data(), sizeof(T), buffer.size());
+        ::k_msgq_init(this, buffer.data(), sizeof(T), buffer.size() / sizeof(T));
+    }
+
+  private:
+#ifdef CONFIG_ZEPHYR_MCPP_STATS
+    int put(const T& msg, k_timeout_t timeout)
+    {
+        const wait_stats::stopwatch sw;
+        const trace::span span;
+        const int status = ::k_msgq_put(this, &msg, timeout);
+        span.end(trace::event::message_queue_post, this, status);
+        stats_.record(sw.elapsed(), status == 0);
+        if (status == 0)
+        {
+            stats_.record_level(size());
+        }
+        return status;
+    }
+    int receive(T& msg, k_timeout_t timeout)
+    {
+        const wait_stats::stopwatch sw;
+        const trace::span span;
+        const int status = ::k_msgq_get(this, static_cast<void*>(&msg), timeout);
+        span.end(trace::event::message_queue_get, this, status);
+        stats_.record(sw.elapsed(), status == 0);
+        return status;
+    }
+
+    wait_stats stats_{wait_stats::object_kind::message_queue, this};
+#else
+    int put(const T& msg, k_timeout_t timeout)
+    {
+        const trace::span span;
+        const int status = ::k_msgq_put(this, &msg, timeout);
+        span.end(trace::event::message_queue_post, this, status);
+        return status;
+    }
+    int receive(T& msg, k_timeout_t timeout)
+    {
+        const trace::span span;
+        const int status = ::k_msgq_get(this, static_cast<void*>(&msg), timeout);
+        span.end(trace::event::message_queue_get, this, status);
+        return status;
+    }
+#endif
+
+    std::size_t receive_n(std::span<T> msgs, k_timeout_t timeout)
+    {
+        if (msgs.empty() or (receive(msgs[0], timeout) != 0))
+        {
+            return 0;
+        }
+        scheduler_lock lock;
+        std::size_t n = 1;
+        for (; (n < msgs.size()) and try_get(msgs[n]); ++n)
+        {
+        }
+        return n;
     }
 };
 
@@ -96,9 +300,245 @@ template <typename T, std::size_t SIZE, std::size_t ALIGN = alignof(T)>
 struct message_queue_instance final : public message_queue<T>
 {
     message_queue_instance() : message_queue<T>(msgq_buffer_) {}
+    /// @brief  Initializes the queue at compile time, for constinit definitions.
+    ZEPHYR_MCPP_STATIC_CONSTEXPR message_queue_instance(static_init_t)
+        : message_queue<T>(static_init, msgq_buffer_), msgq_buffer_{}
+    {}
 
   private:
     char msgq_buffer_[SIZE * sizeof(T)] alignas(ALIGN);
 };
 
+/// @brief  Wait-free single producer, single consumer ring buffer. Unlike @ref message_queue
+///         it doesn't enter the kernel when transferring messages, the consumer is only
+///         woken up (via the @ref readable semaphore) when the ring turns non-empty.
+///         The producer may run in ISR context, the consumer may block, or add
+///         @ref readable to a @ref poll_event set.
+template <typename T, std::size_t N>
+class spsc_ring
+{
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "spsc_ring copies messages bytewise, T must be trivially copyable");
+    static_assert((N > 0) and ((N & (N - 1)) == 0), "spsc_ring size must be a power of two");
+
+    using index = std::size_t;
+    static_assert(std::atomic<index>::is_always_lock_free);
+
+  public:
+    spsc_ring() = default;
+    spsc_ring(const spsc_ring&) = delete;
+    spsc_ring& operator=(const spsc_ring&) = delete;
+
+    static constexpr std::size_t max_size() { return N; }
+
+    /// @brief  Adds a message to the ring, if there is free space for it.
+    /// @param  msg: the message to add
+    /// @return true if the message was added, false if the ring is full
+    /// @remark Producer side, thread and ISR context callable
+    bool try_push(const T& msg) { return try_push_n(std::span<const T>(&msg, 1)) == 1; }
+
+    /// @brief  Adds the leading messages of the batch that fit in the ring.
+    /// @param  msgs: the messages to add, in order
+    /// @return the number of messages added
+    /// @remark Producer side, thread and ISR context callable
+    std::size_t try_push_n(std::span<const T> msgs)
+    {
+        const index head = producer_.head.load(std::memory_order_relaxed);
+        if ((head - producer_.tail_cache + msgs.size()) > N)
+        {
+            producer_.tail_cache = consumer_.tail.load(std::memory_order_acquire);
+        }
+        const std::size_t n = std::min(msgs.size(), N - (head - producer_.tail_cache));
+        if (n == 0)
+        {
+            return 0;
+        }
+        copy_in(head, msgs.first(n));
+        producer_.head.store(head + n, std::memory_order_release);
+
+        // pairs with the consumer's fence before going to sleep; the load acquires too,
+        // as the next push overwrites the slots freed up to the cached tail
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        producer_.tail_cache = consumer_.tail.load(std::memory_order_acquire);
+        if (producer_.tail_cache == head)
+        {
+            readable_.release();
+        }
+        return n;
+    }
+
+    /// @brief  Removes the oldest message from the ring, if there is any.
+    /// @param  msg: the storage to receive into, only written on success
+    /// @return true if a message was received, false if the ring is empty
+    /// @remark Consumer side, thread and ISR context callable
+    bool try_pop(T& msg) { return try_pop_n(std::span<T>(&msg, 1)) == 1; }
+
+    /// @brief  Removes as many of the queued messages as the span fits.
+    /// @param  msgs: the storage to receive into
+    /// @return the number of messages received
+    /// @remark Consumer side, thread and ISR context callable
+    std::size_t try_pop_n(std::span<T> msgs)
+    {
+        const index tail = consumer_.tail.load(std::memory_order_relaxed);
+        if ((consumer_.head_cache - tail) < msgs.size())
+        {
+            consumer_.head_cache = producer_.head.load(std::memory_order_acquire);
+        }
+        const std::size_t n = std::min(msgs.size(), consumer_.head_cache - tail);
+        if (n == 0)
+        {
+            return 0;
+        }
+        copy_out(tail, msgs.first(n));
+        consumer_.tail.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    /// @brief  Removes the oldest message from the ring, blocking until one is available.
+    /// @param  msg: the storage to receive into
+    /// @remark Consumer side, thread context callable
+    void pop(T& msg) { pop_n(std::span<T>(&msg, 1)); }
+
+    /// @brief  Removes the oldest message from the ring.
+    /// @param  msg: the storage to receive into, only written on success
+    /// @param  rel_time: duration to wait for a message
+    /// @return true if a message was received, false if timed out
+    /// @remark Consumer side, thread context callable
+    template <class Rep, class Period>
+    bool try_pop_for(T& msg, const std::chrono::duration<Rep, Period>& rel_time)
+    {
+        return try_pop_n_for(std::span<T>(&msg, 1), rel_time) == 1;
+    }
+
+    /// @brief  Removes the oldest message from the ring.
+    /// @param  msg: the storage to receive into, only written on success
+    /// @param  abs_time: deadline to wait for a message
+    /// @return true if a message was received, false if timed out
+    /// @remark Consumer side, thread context callable
+    template <class Clock, class Duration>
+    bool try_pop_until(T& msg, const std::chrono::time_point<Clock, Duration>& abs_time)
+    {
+        return try_pop_n_until(std::span<T>(&msg, 1), abs_time) == 1;
+    }
+
+    /// @brief  Removes a batch of messages, blocking until at least one is available,
+    ///         then draining as many of the queued messages as the span fits.
+    /// @param  msgs: the storage to receive into
+    /// @return the number of messages received
+    /// @remark Consumer side, thread context callable
+    std::size_t pop_n(std::span<T> msgs)
+    {
+        std::size_t n;
+        while (((n = try_pop_n(msgs)) == 0) and !msgs.empty())
+        {
+            if (empty_after_fence())
+            {
+                readable_.acquire();
+            }
+        }
+        return n;
+    }
+
+    /// @brief  Removes a batch of messages, waiting for at least one to become available,
+    ///         then draining as many of the queued messages as the span fits.
+    /// @param  msgs: the storage to receive into
+    /// @param  abs_time: deadline to wait for the first message
+    /// @return the number of messages received, 0 if timed out
+    /// @remark Consumer side, thread context callable
+    template <class Clock, class Duration>
+    std::size_t try_pop_n_until(std::span<T> msgs,
+                                const std::chrono::time_point<Clock, Duration>& abs_time)
+    {
+        std::size_t n;
+        while (((n = try_pop_n(msgs)) == 0) and !msgs.empty())
+        {
+            if (empty_after_fence() and !readable_.try_acquire_until(abs_time))
+            {
+                return try_pop_n(msgs);
+            }
+        }
+        return n;
+    }
+
+    /// @brief  Removes a batch of messages, waiting for at least one to become available,
+    ///         then draining as many of the queued messages as the span fits.
+    /// @param  msgs: the storage to receive into
+    /// @param  rel_time: duration to wait for the first message
+    /// @return the number of messages received, 0 if timed out
+    /// @remark Consumer side, thread context callable
+    template <class Rep, class Period>
+    std::size_t try_pop_n_for(std::span<T> msgs, const std::chrono::duration<Rep, Period>& rel_time)
+    {
+        if (rel_time == infinity)
+        {
+            return pop_n(msgs);
+        }
+        return try_pop_n_until(msgs, tick_timer::now() + rel_time);
+    }
+
+    /// @brief  The semaphore that becomes available when the ring turns non-empty.
+    ///         Use it to construct a @ref poll_event, and take it before draining the ring
+    ///         to prevent spurious wake-ups.
+    ::k_sem& readable() { return readable_; }
+
+    std::size_t size() const
+    {
+        return producer_.head.load(std::memory_order_acquire) -
+               consumer_.tail.load(std::memory_order_acquire);
+    }
+    bool empty() const { return size() == 0; }
+    bool full() const { return size() == N; }
+
+  private:
+    bool empty_after_fence()
+    {
+        // pairs with the producer's fence after publishing
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return producer_.head.load(std::memory_order_relaxed) ==
+               consumer_.tail.load(std::memory_order_relaxed);
+    }
+
+    void copy_in(index head, std::span<const T> msgs)
+    {
+        const std::size_t first = std::min(msgs.size(), N - (head & (N - 1)));
+        std::copy_n(msgs.begin(), first, &buffer_[head & (N - 1)]);
+        std::copy(msgs.begin() + first, msgs.end(), &buffer_[0]);
+    }
+
+    void copy_out(index tail, std::span<T> msgs) const
+    {
+        const std::size_t first = std::min(msgs.size(), N - (tail & (N - 1)));
+        std::copy_n(&buffer_[tail & (N - 1)], first, msgs.begin());
+        std::copy_n(&buffer_[0], msgs.size() - first, msgs.begin() + first);
+    }
+
+    struct alignas(cache_line_size) producer_side
+    {
+        std::atomic<index> head{};
+        index tail_cache{};
+    };
+    struct alignas(cache_line_size) consumer_side
+    {
+        std::atomic<index> tail{};
+        index head_cache{};
+    };
+
+    producer_side producer_{};
+    consumer_side consumer_{};
+    binary_semaphore readable_{0};
+    T buffer_[N];
+};
+
 } // namespace zephyr
+
+/// @brief  Defines a message_queue that is initialized at compile time, and placed
+///         in the kernel's message queue section, like K_MSGQ_DEFINE.
+/// @param  name: the name of the message queue variable
+/// @param  T: the message type
+/// @param  size: the maximal number of queued messages
+#define ZEPHYR_MESSAGE_QUEUE_DEFINE(name, T, size)                                                 \
+    alignas(T) static char __noinit _zephyr_msgq_buf_##name[(size) * sizeof(T)];                   \
+    ZEPHYR_MCPP_STATIC_OBJECT(k_msgq, ::zephyr::message_queue<T>, name)                            \
+    {                                                                                              \
+        ::zephyr::static_init, _zephyr_msgq_buf_##name                                             \
+    }
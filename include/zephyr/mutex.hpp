@@ -0,0 +1,398 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <zephyr/sys/atomic.h>
+#include "zephyr/cpu.hpp"
+#include "zephyr/stats.hpp"
+#include "zephyr/tick_timer.hpp"
+
+namespace zephyr
+{
+/// @brief  Priority inheriting, recursive mutex, meets the TimedLockable requirements,
+///         so it can be used with std::lock_guard, std::unique_lock and std::scoped_lock.
+///         Unlike @ref critical_section, it leaves the interrupts enabled,
+///         but it can't be used in ISR context.
+struct mutex final : public ::k_mutex
+{
+    mutex(const mutex&) = delete;
+    mutex& operator=(const mutex&) = delete;
+
+    mutex() { ::k_mutex_init(this); }
+
+    /// @remark Thread context callable
+    void lock() { take(K_FOREVER); }
+
+    /// @remark Thread context callable
+    bool try_lock() { return take(K_NO_WAIT) == 0; }
+
+    /// @remark Thread context callable
+    template <class Rep, class Period>
+    bool try_lock_for(const std::chrono::duration<Rep, Period>& rel_time)
+    {
+        return take(to_timeout(rel_time)) == 0;
+    }
+
+    /// @remark Thread context callable
+    template <class Clock, class Duration>
+    bool try_lock_until(const std::chrono::time_point<Clock, Duration>& abs_time)
+    {
+        return take(timeout_until(abs_time)) == 0;
+    }
+
+    /// @remark Thread context callable, by the owner thread
+    void unlock() { ::k_mutex_unlock(this); }
+
+#ifdef CONFIG_ZEPHYR_MCPP_STATS
+    const wait_stats& stats() const { return stats_; }
+    wait_stats& stats() { return stats_; }
+
+  private:
+    int take(k_timeout_t timeout)
+    {
+        const wait_stats::stopwatch sw;
+        const int status = ::k_mutex_lock(this, timeout);
+        stats_.record(sw.elapsed(), status == 0);
+        return status;
+    }
+
+    wait_stats stats_{wait_stats::object_kind::mutex, this};
+#else
+  private:
+    int take(k_timeout_t timeout) { return ::k_mutex_lock(this, timeout); }
+#endif
+};
+
+/// @brief  Reader-writer lock, meets the SharedTimedMutex requirements,
+///         so it can be used with std::shared_lock as well.
+///         Any number of readers may hold the lock at the same time, while a writer
+///         holds it exclusively. Waiting writers block new readers, so writers don't starve.
+class shared_mutex
+{
+  public:
+    shared_mutex(const shared_mutex&) = delete;
+    shared_mutex& operator=(const shared_mutex&) = delete;
+
+    shared_mutex()
+    {
+        ::k_mutex_init(&state_lock_);
+        ::k_condvar_init(&readable_);
+        ::k_condvar_init(&writable_);
+    }
+
+    /// @remark Thread context callable
+    void lock() { acquire(tick_timer::time_point::max()); }
+
+    /// @remark Thread context callable
+    bool try_lock() { return acquire(tick_timer::time_point{}); }
+
+    /// @remark Thread context callable
+    template <class Rep, class Period>
+    bool try_lock_for(const std::chrono::duration<Rep, Period>& rel_time)
+    {
+        return acquire(detail::to_deadline(rel_time));
+    }
+
+    /// @remark Thread context callable
+    template <class Clock, class Duration>
+    bool try_lock_until(const std::chrono::time_point<Clock, Duration>& abs_time)
+    {
+        return acquire(detail::to_deadline(abs_time));
+    }
+
+    /// @remark Thread context callable
+    void unlock()
+    {
+        ::k_mutex_lock(&state_lock_, K_FOREVER);
+        writer_ = false;
+        wake_waiters();
+        ::k_mutex_unlock(&state_lock_);
+    }
+
+    /// @remark Thread context callable
+    void lock_shared() { acquire_shared(tick_timer::time_point::max()); }
+
+    /// @remark Thread context callable
+    bool try_lock_shared() { return acquire_shared(tick_timer::time_point{}); }
+
+    /// @remark Thread context callable
+    template <class Rep, class Period>
+    bool try_lock_shared_for(const std::chrono::duration<Rep, Period>& rel_time)
+    {
+        return acquire_shared(detail::to_deadline(rel_time));
+    }
+
+    /// @remark Thread context callable
+    template <class Clock, class Duration>
+    bool try_lock_shared_until(const std::chrono::time_point<Clock, Duration>& abs_time)
+    {
+        return acquire_shared(detail::to_deadline(abs_time));
+    }
+
+    /// @remark Thread context callable
+    void unlock_shared()
+    {
+        ::k_mutex_lock(&state_lock_, K_FOREVER);
+        --readers_;
+        wake_waiters();
+        ::k_mutex_unlock(&state_lock_);
+    }
+
+  private:
+    static k_timeout_t wait_time(const tick_timer::time_point& deadline)
+    {
+        return to_timeout(detail::remaining(deadline));
+    }
+
+    bool writable() const { return !writer_ and (readers_ == 0); }
+    bool readable() const { return !writer_ and (waiting_writers_ == 0); }
+
+    /// @brief  Passes the lock on to a waiting writer, or all waiting readers.
+    void wake_waiters()
+    {
+        if (waiting_writers_ > 0)
+        {
+            if (writable())
+            {
+                ::k_condvar_signal(&writable_);
+            }
+        }
+        else if (!writer_)
+        {
+            ::k_condvar_broadcast(&readable_);
+        }
+    }
+
+    bool acquire(const tick_timer::time_point& deadline)
+    {
+        if (::k_mutex_lock(&state_lock_, wait_time(deadline)) != 0)
+        {
+            return false;
+        }
+        ++waiting_writers_;
+        while (!writable() and
+               (::k_condvar_wait(&writable_, &state_lock_, wait_time(deadline)) == 0))
+        {
+        }
+        --waiting_writers_;
+        const bool acquired = writable();
+        if (acquired)
+        {
+            writer_ = true;
+        }
+        else
+        {
+            // the wake-up might have been meant for this writer
+            wake_waiters();
+        }
+        ::k_mutex_unlock(&state_lock_);
+        return acquired;
+    }
+
+    bool acquire_shared(const tick_timer::time_point& deadline)
+    {
+        if (::k_mutex_lock(&state_lock_, wait_time(deadline)) != 0)
+        {
+            return false;
+        }
+        while (!readable() and
+               (::k_condvar_wait(&readable_, &state_lock_, wait_time(deadline)) == 0))
+        {
+        }
+        const bool acquired = readable();
+        if (acquired)
+        {
+            ++readers_;
+        }
+        ::k_mutex_unlock(&state_lock_);
+        return acquired;
+    }
+
+    ::k_mutex state_lock_;
+    ::k_condvar readable_;
+    ::k_condvar writable_;
+    std::uint32_t readers_{};
+    std::uint32_t waiting_writers_{};
+    bool writer_{};
+};
+
+/// @brief  Sequence lock, protecting data that is read far more often than written.
+///         Readers (in thread or ISR context) take consistent snapshots without locking,
+///         retrying when a write overlapped. Writers are serialized by a spinlock,
+///         so a reader never spins on a write that it interrupted on its own CPU.
+/// @tparam T: the protected data, copied on each access, so keep it small
+template <typename T>
+class seqlock
+{
+    static_assert(std::is_trivially_copyable_v<T>, "seqlock copies T bytewise");
+    using word = std::uintptr_t;
+    static constexpr std::size_t words = (sizeof(T) + sizeof(word) - 1) / sizeof(word);
+
+  public:
+    seqlock(const seqlock&) = delete;
+    seqlock& operator=(const seqlock&) = delete;
+
+    explicit seqlock(const T& value = T{}) { write(value); }
+
+    /// @brief  Takes a consistent snapshot of the data.
+    /// @remark Thread and ISR context callable
+    T load() const
+    {
+        T value;
+        while (!try_load(value))
+        {
+        }
+        return value;
+    }
+
+    /// @brief  Takes a snapshot of the data, unless a write is overlapping.
+    /// @param  value: the storage to copy into, it's only consistent on success
+    /// @return true if the snapshot is consistent, false if it should be retried
+    /// @remark Thread and ISR context callable
+    bool try_load(T& value) const
+    {
+        const std::uint32_t seq = sequence_.load(std::memory_order_acquire);
+        if ((seq & 1) != 0)
+        {
+            return false;
+        }
+        read(value);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return sequence_.load(std::memory_order_relaxed) == seq;
+    }
+
+    /// @brief  Replaces the data.
+    /// @remark Thread and ISR context callable
+    void store(const T& value)
+    {
+        critical_section cs(lock_);
+        write(value);
+    }
+
+    /// @brief  Modifies the data in place.
+    /// @param  fn: callable with a T& parameter, it must not block
+    /// @remark Thread and ISR context callable
+    template <typename F>
+    void update(F&& fn)
+    {
+        critical_section cs(lock_);
+        T value;
+        read(value);
+        fn(value);
+        write(value);
+    }
+
+  private:
+    void read(T& value) const
+    {
+        word buffer[words];
+        for (std::size_t i = 0; i < words; ++i)
+        {
+            buffer[i] = data_[i].load(std::memory_order_relaxed);
+        }
+        std::memcpy(static_cast<void*>(&value), buffer, sizeof(T));
+    }
+
+    void write(const T& value)
+    {
+        word buffer[words]{};
+        std::memcpy(buffer, static_cast<const void*>(&value), sizeof(T));
+        const std::uint32_t seq = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < words; ++i)
+        {
+            data_[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        sequence_.store(seq + 2, std::memory_order_release);
+    }
+
+    std::atomic<std::uint32_t> sequence_{};
+    std::atomic<word> data_[words]{};
+    spinlock lock_{};
+};
+
+/// @brief  Mutex that is taken and given with atomic operations on its own memory,
+///         and only calls into the kernel (k_futex_wait/k_futex_wake) when contended,
+///         which saves the system calls of the uncontended locks in user mode threads.
+///         Meets the TimedLockable requirements. Unlike @ref mutex, it's neither recursive
+///         nor priority inheriting.
+///         Requires CONFIG_USERSPACE. The object must be a kernel object: statically defined
+///         (so that the kernel object generator finds it), or allocated with k_object_alloc();
+///         granting the user threads access to its memory alone isn't enough.
+class fast_mutex
+{
+  public:
+    fast_mutex(const fast_mutex&) = delete;
+    fast_mutex& operator=(const fast_mutex&) = delete;
+
+    constexpr fast_mutex() = default;
+
+    /// @remark Thread context callable
+    void lock()
+    {
+        if (!try_lock())
+        {
+            lock_contended(tick_timer::time_point::max());
+        }
+    }
+
+    /// @remark Thread context callable
+    bool try_lock() { return ::atomic_cas(&futex_.val, unlocked, locked); }
+
+    /// @remark Thread context callable
+    template <class Rep, class Period>
+    bool try_lock_for(const std::chrono::duration<Rep, Period>& rel_time)
+    {
+        return try_lock() or lock_contended(detail::to_deadline(rel_time));
+    }
+
+    /// @remark Thread context callable
+    template <class Clock, class Duration>
+    bool try_lock_until(const std::chrono::time_point<Clock, Duration>& abs_time)
+    {
+        return try_lock() or lock_contended(detail::to_deadline(abs_time));
+    }
+
+    /// @remark Thread context callable, by the owner thread
+    void unlock()
+    {
+        if (::atomic_dec(&futex_.val) != locked)
+        {
+            ::atomic_set(&futex_.val, unlocked);
+            ::k_futex_wake(&futex_, false);
+        }
+    }
+
+  private:
+    enum : ::atomic_val_t
+    {
+        unlocked,
+        locked,
+        /// locked, and the unlocking thread has to wake up a waiting one
+        contended,
+    };
+
+    bool lock_contended(const tick_timer::time_point& deadline)
+    {
+        while (::atomic_set(&futex_.val, contended) != unlocked)
+        {
+            const int err =
+                ::k_futex_wait(&futex_, contended, detail::deadline_timeout(deadline));
+            // -EINVAL means that the futex isn't a kernel object, retrying would spin forever
+            __ASSERT((err == 0) or (err == -EAGAIN) or (err == -ETIMEDOUT),
+                     "k_futex_wait failed: %d", err);
+            if ((err != 0) and (err != -EAGAIN))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    ::k_futex futex_{};
+};
+
+} // namespace zephyr
@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include "zephyr/cpu.hpp"
+
+namespace zephyr
+{
+/// @brief  One instance of T for each CPU, in separate cache lines, so that the CPUs can
+///         update their own instance (e.g. hot statistics counters) without bouncing
+///         cache lines between each other. An aggregating reader visits all instances.
+///         Each slot has its own spinlock, which is only contended while being aggregated.
+template <typename T>
+class per_cpu
+{
+    struct alignas(cache_line_size) slot
+    {
+        mutable ::k_spinlock lock{};
+        T value{};
+    };
+
+  public:
+#ifdef CONFIG_MP_MAX_NUM_CPUS
+    static constexpr std::size_t max_cpus = CONFIG_MP_MAX_NUM_CPUS;
+#else
+    static constexpr std::size_t max_cpus = 1;
+#endif
+
+    /// @brief  Exclusive access to the current CPU's instance. The local interrupts are
+    ///         masked while it exists, so the caller can't migrate to another CPU meanwhile.
+    class local_ref
+    {
+      public:
+        local_ref(const local_ref&) = delete;
+        local_ref& operator=(const local_ref&) = delete;
+        ~local_ref() { ::k_spin_unlock(&slot_.lock, key_); }
+
+        T& operator*() const { return slot_.value; }
+        T* operator->() const { return &slot_.value; }
+
+      private:
+        friend class per_cpu;
+
+        explicit local_ref(slot& s) : slot_(s), key_(::k_spin_lock(&slot_.lock)) {}
+
+        slot& slot_;
+        ::k_spinlock_key_t key_;
+    };
+
+    per_cpu(const per_cpu&) = delete;
+    per_cpu& operator=(const per_cpu&) = delete;
+
+    per_cpu() = default;
+    explicit per_cpu(const T& value)
+    {
+        for (auto& s : slots_)
+        {
+            s.value = value;
+        }
+    }
+
+    /// @brief  The number of CPUs in use, the number of instances visited by @ref for_each.
+    static std::size_t size() { return std::min<std::size_t>(::arch_num_cpus(), max_cpus); }
+
+    /// @brief  Locks the current CPU's instance for access.
+    /// @remark Thread and ISR context callable
+    local_ref local()
+    {
+        // a migration right after reading the id only makes the lock contended
+        return local_ref(slots_[this_cpu::id()]);
+    }
+
+    /// @brief  Calls the function with the current CPU's instance, keeping the local
+    ///         interrupts masked meanwhile, so the function must be short.
+    /// @param  fn: callable with a T& parameter
+    /// @return the function's return value
+    /// @remark Thread and ISR context callable
+    template <typename F>
+    decltype(auto) apply(F&& fn)
+    {
+        auto ref = local();
+        return std::forward<F>(fn)(*ref);
+    }
+
+    /// @brief  Calls the function with each CPU's instance in turn, while locking it.
+    /// @param  fn: callable with (unsigned cpu, const T&) parameters, it must not block
+    /// @remark Thread and ISR context callable
+    template <typename F>
+    void for_each(F&& fn) const
+    {
+        for (std::size_t cpu = 0; cpu < size(); ++cpu)
+        {
+            const slot& s = slots_[cpu];
+            const ::k_spinlock_key_t key = ::k_spin_lock(&s.lock);
+            fn(static_cast<unsigned>(cpu), s.value);
+            ::k_spin_unlock(&s.lock, key);
+        }
+    }
+
+    /// @brief  Aggregates the instances of all CPUs.
+    /// @param  init: the initial value of the accumulator
+    /// @param  op: callable returning the new accumulator from (accumulator, const T&)
+    /// @return the accumulated value
+    /// @remark Thread and ISR context callable
+    template <typename U, typename BinaryOp>
+    U reduce(U init, BinaryOp op) const
+    {
+        for_each([&](unsigned, const T& value) { init = op(std::move(init), value); });
+        return init;
+    }
+
+  private:
+    slot slots_[max_cpus]{};
+};
+
+} // namespace zephyr
@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include "zephyr/cpu.hpp"
+#include "zephyr/thread.hpp"
+#include "zephyr/work_queue.hpp"
+
+namespace zephyr
+{
+/// @brief  Thread that runs a job at a fixed rate, with a relative deadline for each job.
+///         Each activation re-arms the thread's scheduler deadline (with
+///         CONFIG_SCHED_DEADLINE), so tasks of the same priority are scheduled
+///         earliest deadline first. For rate-monotonic scheduling instead,
+///         give the shorter period tasks the higher priorities.
+///         The response time of each job is measured from its activation,
+///         to check the schedulability of the task set on target.
+/// @tparam STACK_SIZE: the stack size of the task's thread
+/// @tparam CAPACITY: the inline storage size of the job callable
+template <std::size_t STACK_SIZE, std::size_t CAPACITY = 2 * sizeof(void*)>
+class periodic_task
+{
+  public:
+    struct statistics
+    {
+        std::uint32_t jobs{};
+        /// the number of jobs that completed after their deadline
+        std::uint32_t deadline_misses{};
+        /// the number of activations skipped, because the previous job overran its period
+        std::uint32_t skipped{};
+        tick_timer::duration max_response_time{tick_timer::duration::zero()};
+        tick_timer::duration total_response_time{tick_timer::duration::zero()};
+
+        tick_timer::duration mean_response_time() const
+        {
+            return jobs > 0 ? total_response_time / jobs : tick_timer::duration::zero();
+        }
+    };
+
+    periodic_task(const periodic_task&) = delete;
+    periodic_task& operator=(const periodic_task&) = delete;
+
+    /// @brief  Starts the task's thread, the first job is activated one period later.
+    /// @param  period: the time between job activations
+    /// @param  deadline: the time each job has to complete, from its activation
+    /// @param  prio: the priority of the task's thread
+    /// @param  job: the callable to run at each activation
+    template <class Rep1, class Period1, class Rep2, class Period2, typename F>
+    periodic_task(const std::chrono::duration<Rep1, Period1>& period,
+                  const std::chrono::duration<Rep2, Period2>& deadline,
+                  zephyr::thread::priority prio, F&& job)
+        : timing_(period), deadline_(std::chrono::ceil<tick_timer::duration>(deadline)),
+          job_(std::forward<F>(job)), thread_(stack_, &run, this, nullptr, nullptr, prio)
+    {}
+
+    /// @brief  Stops the task after its current period, and waits for its thread to exit.
+    ~periodic_task()
+    {
+        stopping_.store(true, std::memory_order_relaxed);
+        thread_.join(infinity);
+    }
+
+    zephyr::thread& get_thread() { return thread_; }
+    tick_timer::duration period() const { return timing_.period(); }
+    tick_timer::duration deadline() const { return deadline_; }
+
+    /// @brief  A snapshot of the statistics, consistent with the job updating them.
+    statistics stats() const
+    {
+        critical_section cs(lock_);
+        return stats_;
+    }
+    void reset_stats()
+    {
+        critical_section cs(lock_);
+        stats_ = {};
+    }
+
+  private:
+    static void run(void* p1, void*, void*)
+    {
+        auto& self = *static_cast<periodic_task*>(p1);
+        for (;;)
+        {
+            self.timing_.wait();
+            if (self.stopping_.load(std::memory_order_relaxed))
+            {
+                return;
+            }
+            const auto release = self.timing_.next_activation() - self.timing_.period();
+#ifdef CONFIG_SCHED_DEADLINE
+            self.thread_.set_deadline(release + self.deadline_ - tick_timer::now());
+#endif
+            self.job_();
+            self.record(tick_timer::now() - release);
+        }
+    }
+
+    void record(tick_timer::duration response_time)
+    {
+        // the timing is only accessed by the task's thread, its skip count is accumulated
+        // so that resetting the statistics doesn't race with it
+        const auto skipped = timing_.stats().skipped;
+        critical_section cs(lock_);
+        stats_.skipped += skipped - last_skipped_;
+        last_skipped_ = skipped;
+        ++stats_.jobs;
+        if (response_time > deadline_)
+        {
+            ++stats_.deadline_misses;
+        }
+        stats_.max_response_time = std::max(stats_.max_response_time, response_time);
+        stats_.total_response_time += response_time;
+    }
+
+    periodic timing_;
+    const tick_timer::duration deadline_;
+    detail::inline_function<CAPACITY> job_;
+    std::atomic<bool> stopping_{};
+    mutable spinlock lock_{};
+    statistics stats_{};
+    std::uint32_t last_skipped_{};
+    zephyr::thread thread_;
+    K_KERNEL_STACK_MEMBER(stack_, STACK_SIZE);
+};
+
+} // namespace zephyr
@@ -0,0 +1,348 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/ring_buffer.h>
+#include "zephyr/cpu.hpp"
+#include "zephyr/semaphore.hpp"
+#include "zephyr/tick_timer.hpp"
+
+namespace zephyr
+{
+/// @brief  Byte stream between threads and ISRs, over a ring buffer (requires
+///         CONFIG_RING_BUFFER). Transfers take a span of bytes and move as many of them
+///         as possible with a single copy, instead of entering the kernel per byte.
+///         The blocking transfers wait until at least a minimal number of bytes
+///         can be transferred at once, so they either transfer that much, or nothing:
+///         pass the span size for all-or-nothing transfers, or 1 for partial ones.
+///         Each transfer wakes up all the blocked threads of the other side, so that
+///         each of them re-checks its own minimal number of bytes.
+class pipe
+{
+  public:
+    pipe(const pipe&) = delete;
+    pipe& operator=(const pipe&) = delete;
+
+    /// @brief  Creates the pipe over an external buffer.
+    /// @param  buffer: the storage of the buffered bytes, it must outlive the pipe
+    explicit pipe(std::span<std::byte> buffer)
+    {
+        ::ring_buf_init(&ring_, static_cast<std::uint32_t>(buffer.size()),
+                        reinterpret_cast<std::uint8_t*>(buffer.data()));
+    }
+
+    /// @brief  Writes as many of the bytes as there is free space for.
+    /// @param  data: the bytes to write
+    /// @return the number of bytes written
+    /// @remark Thread and ISR context callable
+    std::size_t try_write(std::span<const std::byte> data) { return transmit(data, 1); }
+
+    /// @brief  Writes the bytes, blocking until there is free space for at least
+    ///         the minimal number of them.
+    /// @param  data: the bytes to write
+    /// @param  min_bytes: the minimal number of bytes to write, at most @ref capacity
+    /// @return the number of bytes written, at least min_bytes
+    /// @remark Thread context callable
+    std::size_t write(std::span<const std::byte> data, std::size_t min_bytes)
+    {
+        return write_until(data, min_bytes, tick_timer::time_point::max());
+    }
+
+    /// @brief  Writes the bytes, if free space for at least the minimal number of them
+    ///         becomes available in time.
+    /// @param  data: the bytes to write
+    /// @param  min_bytes: the minimal number of bytes to write, at most @ref capacity
+    /// @param  rel_time: duration to wait for free space
+    /// @return the number of bytes written, 0 if timed out
+    /// @remark Thread context callable
+    template <class Rep, class Period>
+    std::size_t try_write_for(std::span<const std::byte> data, std::size_t min_bytes,
+                              const std::chrono::duration<Rep, Period>& rel_time)
+    {
+        return write_until(data, min_bytes, detail::to_deadline(rel_time));
+    }
+
+    /// @brief  Writes the bytes, if free space for at least the minimal number of them
+    ///         becomes available in time.
+    /// @param  data: the bytes to write
+    /// @param  min_bytes: the minimal number of bytes to write, at most @ref capacity
+    /// @param  abs_time: deadline to wait for free space
+    /// @return the number of bytes written, 0 if timed out
+    /// @remark Thread context callable
+    template <class Clock, class Duration>
+    std::size_t try_write_until(std::span<const std::byte> data, std::size_t min_bytes,
+                                const std::chrono::time_point<Clock, Duration>& abs_time)
+    {
+        return write_until(data, min_bytes, detail::to_deadline(abs_time));
+    }
+
+    /// @brief  Reads as many bytes as are buffered, up to the span size.
+    /// @param  data: the storage to read into
+    /// @return the number of bytes read
+    /// @remark Thread and ISR context callable
+    std::size_t try_read(std::span<std::byte> data) { return receive(data, 1); }
+
+    /// @brief  Reads bytes, blocking until at least the minimal number of them are buffered.
+    /// @param  data: the storage to read into
+    /// @param  min_bytes: the minimal number of bytes to read, at most @ref capacity
+    /// @return the number of bytes read, at least min_bytes
+    /// @remark Thread context callable
+    std::size_t read(std::span<std::byte> data, std::size_t min_bytes)
+    {
+        return read_until(data, min_bytes, tick_timer::time_point::max());
+    }
+
+    /// @brief  Reads bytes, if at least the minimal number of them are buffered in time.
+    /// @param  data: the storage to read into
+    /// @param  min_bytes: the minimal number of bytes to read, at most @ref capacity
+    /// @param  rel_time: duration to wait for the bytes
+    /// @return the number of bytes read, 0 if timed out
+    /// @remark Thread context callable
+    template <class Rep, class Period>
+    std::size_t try_read_for(std::span<std::byte> data, std::size_t min_bytes,
+                             const std::chrono::duration<Rep, Period>& rel_time)
+    {
+        return read_until(data, min_bytes, detail::to_deadline(rel_time));
+    }
+
+    /// @brief  Reads bytes, if at least the minimal number of them are buffered in time.
+    /// @param  data: the storage to read into
+    /// @param  min_bytes: the minimal number of bytes to read, at most @ref capacity
+    /// @param  abs_time: deadline to wait for the bytes
+    /// @return the number of bytes read, 0 if timed out
+    /// @remark Thread context callable
+    template <class Clock, class Duration>
+    std::size_t try_read_until(std::span<std::byte> data, std::size_t min_bytes,
+                               const std::chrono::time_point<Clock, Duration>& abs_time)
+    {
+        return read_until(data, min_bytes, detail::to_deadline(abs_time));
+    }
+
+    /// @brief  Claims the contiguous free space at the write position, to be filled
+    ///         in place (e.g. by DMA), then published by @ref commit_write.
+    ///         Only one write claim may be pending, and no other writes may happen
+    ///         until it is committed.
+    /// @param  max_bytes: the maximal size to claim
+    /// @return the claimed space, empty if the pipe is full
+    /// @remark Thread and ISR context callable
+    std::span<std::byte> claim_write(std::size_t max_bytes = max_claim)
+    {
+        std::uint8_t* region;
+        std::uint32_t size;
+        {
+            critical_section cs(lock_);
+            size = ::ring_buf_put_claim(&ring_, &region, clamp(max_bytes));
+        }
+        return {reinterpret_cast<std::byte*>(region), size};
+    }
+
+    /// @brief  Publishes the leading bytes of the claimed space to the readers,
+    ///         releases the rest of the claim.
+    /// @param  bytes: the number of bytes written into the claimed space
+    /// @remark Thread and ISR context callable
+    void commit_write(std::size_t bytes)
+    {
+        {
+            critical_section cs(lock_);
+            ::ring_buf_put_finish(&ring_, static_cast<std::uint32_t>(bytes));
+        }
+        if (bytes > 0)
+        {
+            notify(readable_, readers_);
+        }
+    }
+
+    /// @brief  Claims the contiguous buffered bytes at the read position, to be consumed
+    ///         in place (e.g. by DMA), then freed by @ref commit_read.
+    ///         Only one read claim may be pending, and no other reads may happen
+    ///         until it is committed.
+    /// @param  max_bytes: the maximal size to claim
+    /// @return the claimed bytes, empty if the pipe is empty
+    /// @remark Thread and ISR context callable
+    std::span<const std::byte> claim_read(std::size_t max_bytes = max_claim)
+    {
+        std::uint8_t* region;
+        std::uint32_t size;
+        {
+            critical_section cs(lock_);
+            size = ::ring_buf_get_claim(&ring_, &region, clamp(max_bytes));
+        }
+        return {reinterpret_cast<const std::byte*>(region), size};
+    }
+
+    /// @brief  Frees the leading bytes of the claimed bytes, releases the rest of the claim.
+    /// @param  bytes: the number of bytes consumed from the claimed bytes
+    /// @remark Thread and ISR context callable
+    void commit_read(std::size_t bytes)
+    {
+        {
+            critical_section cs(lock_);
+            ::ring_buf_get_finish(&ring_, static_cast<std::uint32_t>(bytes));
+        }
+        if (bytes > 0)
+        {
+            notify(writable_, writers_);
+        }
+    }
+
+    /// @brief  The semaphore that becomes available when bytes are written.
+    ///         Wait for it with @ref wait_any (which takes it), then read with the
+    ///         non-blocking calls. A raw @ref poll_event only notifies: take the semaphore
+    ///         with K_NO_WAIT after each poll hit, or the following polls return at once.
+    ::k_sem& readable() { return readable_; }
+
+    /// @brief  The semaphore that becomes available when bytes are read, see @ref readable.
+    ::k_sem& writable() { return writable_; }
+
+    std::size_t capacity() const { return ::ring_buf_capacity_get(&ring_); }
+
+    std::size_t size() const
+    {
+        critical_section cs(lock_);
+        return ::ring_buf_size_get(&ring_);
+    }
+
+    std::size_t space() const
+    {
+        critical_section cs(lock_);
+        return ::ring_buf_space_get(&ring_);
+    }
+
+    bool empty() const { return size() == 0; }
+
+    /// @brief  Discards the buffered bytes.
+    void reset()
+    {
+        {
+            critical_section cs(lock_);
+            ::ring_buf_reset(&ring_);
+        }
+        notify(writable_, writers_);
+    }
+
+  private:
+    static constexpr std::size_t max_claim = std::numeric_limits<std::uint32_t>::max();
+
+    static std::uint32_t clamp(std::size_t bytes)
+    {
+        return static_cast<std::uint32_t>(std::min(bytes, max_claim));
+    }
+
+    /// @brief  Wakes up all the blocked threads of a side, or makes the semaphore available
+    ///         to the next one (or a poller). A waiter that gives up in the meantime
+    ///         leaves one spurious wake-up behind at most, as the semaphore is binary.
+    static void notify(binary_semaphore& sem, const ::atomic_t& waiters)
+    {
+        sem.release(std::max<::atomic_val_t>(::atomic_get(&waiters), 1));
+    }
+
+    /// @brief  Copies the bytes in, if at least min_bytes of them fit.
+    std::size_t transmit(std::span<const std::byte> data, std::size_t min_bytes)
+    {
+        std::size_t n = 0;
+        {
+            critical_section cs(lock_);
+            if (::ring_buf_space_get(&ring_) >= std::min(min_bytes, data.size()))
+            {
+                n = ::ring_buf_put(&ring_, reinterpret_cast<const std::uint8_t*>(data.data()),
+                                   clamp(data.size()));
+            }
+        }
+        if (n > 0)
+        {
+            notify(readable_, readers_);
+        }
+        return n;
+    }
+
+    /// @brief  Copies the bytes out, if at least min_bytes of them are buffered.
+    std::size_t receive(std::span<std::byte> data, std::size_t min_bytes)
+    {
+        std::size_t n = 0;
+        {
+            critical_section cs(lock_);
+            if (::ring_buf_size_get(&ring_) >= std::min(min_bytes, data.size()))
+            {
+                n = ::ring_buf_get(&ring_, reinterpret_cast<std::uint8_t*>(data.data()),
+                                   clamp(data.size()));
+            }
+        }
+        if (n > 0)
+        {
+            notify(writable_, writers_);
+        }
+        return n;
+    }
+
+    std::size_t write_until(std::span<const std::byte> data, std::size_t min_bytes,
+                            const tick_timer::time_point& deadline)
+    {
+        __ASSERT_NO_MSG(min_bytes <= capacity());
+        std::size_t n = transmit(data, min_bytes);
+        // nothing transferred already satisfies min_bytes == 0, like k_pipe_put/get's min_xfer
+        if ((n > 0) or data.empty() or (min_bytes == 0))
+        {
+            return n;
+        }
+        // counted before checking once more, so a read in between wakes this writer up
+        ::atomic_inc(&writers_);
+        while ((n = transmit(data, min_bytes)) == 0)
+        {
+            if (!writable_.try_acquire_for(detail::remaining(deadline)))
+            {
+                n = transmit(data, min_bytes);
+                break;
+            }
+        }
+        ::atomic_dec(&writers_);
+        return n;
+    }
+
+    std::size_t read_until(std::span<std::byte> data, std::size_t min_bytes,
+                           const tick_timer::time_point& deadline)
+    {
+        __ASSERT_NO_MSG(min_bytes <= capacity());
+        std::size_t n = receive(data, min_bytes);
+        if ((n > 0) or data.empty() or (min_bytes == 0))
+        {
+            return n;
+        }
+        ::atomic_inc(&readers_);
+        while ((n = receive(data, min_bytes)) == 0)
+        {
+            if (!readable_.try_acquire_for(detail::remaining(deadline)))
+            {
+                n = receive(data, min_bytes);
+                break;
+            }
+        }
+        ::atomic_dec(&readers_);
+        return n;
+    }
+
+    mutable ::ring_buf ring_;
+    mutable spinlock lock_{};
+    binary_semaphore readable_{0};
+    binary_semaphore writable_{0};
+    /// the number of threads blocked in reads and writes
+    ::atomic_t readers_{};
+    ::atomic_t writers_{};
+};
+
+/// @brief  @ref pipe with its own buffer.
+/// @tparam SIZE: the buffer size in bytes
+template <std::size_t SIZE>
+class pipe_instance final : public pipe
+{
+  public:
+    pipe_instance() : pipe(buffer_) {}
+
+  private:
+    std::byte buffer_[SIZE];
+};
+
+} // namespace zephyr
@@ -1,5 +1,12 @@
 // SPDX-License-Identifier: Apache-2.0
 #pragma once
+#include <array>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <variant>
+#include "zephyr/event_group.hpp"
+#include "zephyr/intrusive_queue.hpp"
 #include "zephyr/message_queue.hpp"
 #include "zephyr/semaphore.hpp"
 
@@ -8,6 +15,9 @@ namespace zephyr
 struct signal final : public ::k_poll_signal
 {
     signal() { ::k_poll_signal_init(this); }
+    /// @brief  Initializes the signal at compile time, see @ref ZEPHYR_SIGNAL_DEFINE.
+    constexpr explicit signal(static_init_t) : ::k_poll_signal K_POLL_SIGNAL_INITIALIZER((*this))
+    {}
 
     void raise(int result) { ::k_poll_signal_raise(this, result); }
     void reset() { ::k_poll_signal_reset(this); }
@@ -39,6 +49,10 @@ struct poll_event final : public ::k_poll_event
     {
         ::k_poll_event_init(this, K_POLL_TYPE_SEM_AVAILABLE, K_POLL_MODE_NOTIFY_ONLY, &sem);
     }
+    explicit poll_event(::k_fifo& fifo)
+    {
+        ::k_poll_event_init(this, K_POLL_TYPE_FIFO_DATA_AVAILABLE, K_POLL_MODE_NOTIFY_ONLY, &fifo);
+    }
 
     void reset_state() { this->state = K_POLL_STATE_NOT_READY; }
 };
@@ -49,4 +63,327 @@ inline auto poll_for(std::array<::k_poll_event, N>& events, tick_timer::duration
     return ::k_poll(events.data(), events.size(), to_timeout(timeout));
 }
 
+#ifdef CONFIG_ZEPHYR_MCPP_EVENT_GROUP_POLL
+/// @brief  Selection of @ref event_group flags, as a @ref wait_any source.
+///         The source is ready when any of the flags is raised.
+struct event_flags
+{
+    event_group& group;
+    zephyr::events flags;
+};
+#endif
+
+namespace detail
+{
+/// @brief  Adapters of the @ref wait_any sources, each creates the poll event of the source,
+///         tells when the source is ready, and takes the result from it without blocking.
+struct semaphore_source
+{
+    using result_type = std::monostate;
+    static constexpr bool checks_state = false;
+
+    ::k_sem& sem;
+
+    poll_event event() const { return poll_event(sem); }
+    bool ready(const ::k_poll_event& e) const { return e.state != K_POLL_STATE_NOT_READY; }
+    std::optional<result_type> take() const
+    {
+        if (::k_sem_take(&sem, K_NO_WAIT) != 0)
+        {
+            return std::nullopt;
+        }
+        return result_type{};
+    }
+};
+
+template <typename T>
+struct message_source
+{
+    using result_type = T;
+    static constexpr bool checks_state = false;
+
+    message_queue<T>& msgq;
+
+    poll_event event() const { return poll_event(msgq); }
+    bool ready(const ::k_poll_event& e) const { return e.state != K_POLL_STATE_NOT_READY; }
+    std::optional<result_type> take() const { return msgq.try_get(); }
+};
+
+template <typename T>
+struct fifo_source
+{
+    using result_type = T*;
+    static constexpr bool checks_state = false;
+
+    intrusive_fifo<T>& fifo;
+
+    poll_event event() const { return poll_event(fifo); }
+    bool ready(const ::k_poll_event& e) const { return e.state != K_POLL_STATE_NOT_READY; }
+    std::optional<result_type> take() const
+    {
+        T* item = fifo.try_get();
+        if (item == nullptr)
+        {
+            return std::nullopt;
+        }
+        return item;
+    }
+};
+
+struct signal_source
+{
+    using result_type = int;
+    static constexpr bool checks_state = false;
+
+    ::k_poll_signal& sig;
+
+    poll_event event() const { return poll_event(sig); }
+    bool ready(const ::k_poll_event& e) const { return e.state != K_POLL_STATE_NOT_READY; }
+    std::optional<result_type> take() const
+    {
+        unsigned int signaled;
+        int result;
+        ::k_poll_signal_check(&sig, &signaled, &result);
+        if (signaled == 0U)
+        {
+            return std::nullopt;
+        }
+        ::k_poll_signal_reset(&sig);
+        return result;
+    }
+};
+
+#ifdef CONFIG_ZEPHYR_MCPP_EVENT_GROUP_POLL
+struct event_flags_source
+{
+    using result_type = zephyr::events;
+    /// the polled signal only reports updates, the flags have to be checked
+    static constexpr bool checks_state = true;
+
+    event_flags source;
+
+    poll_event event() const { return poll_event(source.group.updated()); }
+    bool ready(const ::k_poll_event&) const { return (source.group.get() & source.flags) != 0; }
+    std::optional<result_type> take() const
+    {
+        const auto flags = source.group.wait_any_for(source.flags, tick_timer::duration{0});
+        if (flags == 0)
+        {
+            return std::nullopt;
+        }
+        return flags;
+    }
+};
+
+inline event_flags_source make_source(const event_flags& f)
+{
+    return {f};
+}
+#endif
+
+inline semaphore_source make_source(::k_sem& sem)
+{
+    return {sem};
+}
+
+template <typename T>
+inline message_source<T> make_source(message_queue<T>& msgq)
+{
+    return {msgq};
+}
+
+template <typename T>
+inline fifo_source<T> make_source(intrusive_fifo<T>& fifo)
+{
+    return {fifo};
+}
+
+inline signal_source make_source(::k_poll_signal& sig)
+{
+    return {sig};
+}
+
+/// @brief  Blocks on all sources with a single kernel wait, until one of them is ready
+///         (and the selector accepts it), or the deadline passes.
+/// @param  select: callable with the index_sequence of the sources, returns true
+///         when the wait is over
+template <typename Select, typename... Sources>
+inline bool poll_any(const tick_timer::time_point& deadline, Select&& select,
+                     const std::tuple<Sources...>& sources)
+{
+    constexpr auto indexes = std::index_sequence_for<Sources...>{};
+    auto events = std::apply(
+        [](const auto&... src) {
+            return std::array<poll_event, sizeof...(Sources)>{src.event()...};
+        },
+        sources);
+    for (;;)
+    {
+        int err;
+        if constexpr ((Sources::checks_state or ...))
+        {
+            // the states are checked before the kernel wait, a state change
+            // in the meantime would be missed, unless its notification is held off
+            // until this thread is registered by k_poll()
+            const unsigned int key = ::irq_lock();
+            if (select(events, indexes))
+            {
+                ::irq_unlock(key);
+                return true;
+            }
+            err = ::k_poll(events.data(), static_cast<int>(events.size()),
+                           deadline_timeout(deadline));
+            ::irq_unlock(key);
+        }
+        else
+        {
+            err = ::k_poll(events.data(), static_cast<int>(events.size()),
+                           deadline_timeout(deadline));
+        }
+        if ((err == 0) and select(events, indexes))
+        {
+            return true;
+        }
+        if ((err != 0) or expired(deadline))
+        {
+            return false;
+        }
+        for (auto& e : events)
+        {
+            e.reset_state();
+        }
+    }
+}
+
+template <typename... Sources>
+inline std::optional<std::size_t> wait_any(const tick_timer::time_point& deadline,
+                                           const std::tuple<Sources...>& sources)
+{
+    std::optional<std::size_t> index;
+    const auto select = [&]<std::size_t... I>(const auto& events, std::index_sequence<I...>) {
+        return ((std::get<I>(sources).ready(events[I]) and (index.emplace(I), true)) or ...);
+    };
+    poll_any(deadline, select, sources);
+    return index;
+}
+
+template <typename... Sources>
+using receive_result = std::variant<typename Sources::result_type...>;
+
+template <typename... Sources>
+inline std::optional<receive_result<Sources...>> receive_any(const tick_timer::time_point& deadline,
+                                                            const std::tuple<Sources...>& sources)
+{
+    std::optional<receive_result<Sources...>> result;
+    const auto take = [&]<std::size_t I>(std::integral_constant<std::size_t, I>) {
+        auto value = std::get<I>(sources).take();
+        if (value.has_value())
+        {
+            result.emplace(std::in_place_index<I>, std::move(*value));
+        }
+        return value.has_value();
+    };
+    // losing the race for a ready source to another consumer keeps waiting
+    const auto select = [&]<std::size_t... I>(const auto& events, std::index_sequence<I...>) {
+        return ((std::get<I>(sources).ready(events[I]) and
+                 take(std::integral_constant<std::size_t, I>{})) or
+                ...);
+    };
+    poll_any(deadline, select, sources);
+    return result;
+}
+} // namespace detail
+
+/// @brief  Blocks the current thread until any of the sources is ready, using a single
+///         kernel wait. The sources aren't consumed, the caller takes from the ready one.
+/// @param  sources: semaphores, message queues, intrusive FIFOs, signals and (with
+///         CONFIG_ZEPHYR_MCPP_EVENT_GROUP_POLL) @ref event_flags
+/// @return the index of the first ready source, or empty if the wait failed
+///         (e.g. an intrusive FIFO's wait was cancelled)
+/// @remark Thread context callable
+template <typename... Sources>
+inline std::optional<std::size_t> wait_any(Sources&&... sources)
+{
+    return detail::wait_any(tick_timer::time_point::max(),
+                             std::make_tuple(detail::make_source(sources)...));
+}
+
+/// @brief  Blocks the current thread until any of the sources is ready, using a single
+///         kernel wait. The sources aren't consumed, the caller takes from the ready one.
+/// @param  rel_time: duration to wait for a ready source
+/// @param  sources: semaphores, message queues, intrusive FIFOs, signals and (with
+///         CONFIG_ZEPHYR_MCPP_EVENT_GROUP_POLL) @ref event_flags
+/// @return the index of the first ready source, or empty if timed out
+/// @remark Thread context callable
+template <class Rep, class Period, typename... Sources>
+inline std::optional<std::size_t> wait_any_for(const std::chrono::duration<Rep, Period>& rel_time,
+                                               Sources&&... sources)
+{
+    return detail::wait_any(detail::to_deadline(rel_time),
+                            std::make_tuple(detail::make_source(sources)...));
+}
+
+/// @brief  Blocks the current thread until any of the sources is ready, using a single
+///         kernel wait. The sources aren't consumed, the caller takes from the ready one.
+/// @param  abs_time: deadline to wait for a ready source
+/// @param  sources: semaphores, message queues, intrusive FIFOs, signals and (with
+///         CONFIG_ZEPHYR_MCPP_EVENT_GROUP_POLL) @ref event_flags
+/// @return the index of the first ready source, or empty if timed out
+/// @remark Thread context callable
+template <class Clock, class Duration, typename... Sources>
+inline std::optional<std::size_t>
+wait_any_until(const std::chrono::time_point<Clock, Duration>& abs_time, Sources&&... sources)
+{
+    return detail::wait_any(detail::to_deadline(abs_time),
+                            std::make_tuple(detail::make_source(sources)...));
+}
+
+/// @brief  Blocks the current thread until any of the sources is ready, then takes from it:
+///         acquires the semaphore, receives the message or object, resets the signal,
+///         or clears the raised event flags.
+/// @param  sources: semaphores, message queues, intrusive FIFOs, signals and (with
+///         CONFIG_ZEPHYR_MCPP_EVENT_GROUP_POLL) @ref event_flags
+/// @return the result of the taken source, at the source's index: std::monostate
+///         for semaphores, the message, the object pointer, the signal's result,
+///         or the cleared event flags; or empty if the wait failed (e.g. an intrusive
+///         FIFO's wait was cancelled)
+/// @remark Thread context callable
+template <typename... Sources>
+inline auto receive_any(Sources&&... sources)
+{
+    return detail::receive_any(tick_timer::time_point::max(),
+                                std::make_tuple(detail::make_source(sources)...));
+}
+
+/// @brief  Blocks the current thread until any of the sources is ready, then takes from it.
+/// @param  rel_time: duration to wait for a ready source
+/// @param  sources: the sources, see @ref receive_any
+/// @return the result of the taken source at the source's index, or empty if timed out
+/// @remark Thread context callable
+template <class Rep, class Period, typename... Sources>
+inline auto try_receive_any_for(const std::chrono::duration<Rep, Period>& rel_time,
+                                Sources&&... sources)
+{
+    return detail::receive_any(detail::to_deadline(rel_time),
+                               std::make_tuple(detail::make_source(sources)...));
+}
+
+/// @brief  Blocks the current thread until any of the sources is ready, then takes from it.
+/// @param  abs_time: deadline to wait for a ready source
+/// @param  sources: the sources, see @ref receive_any
+/// @return the result of the taken source at the source's index, or empty if timed out
+/// @remark Thread context callable
+template <class Clock, class Duration, typename... Sources>
+inline auto try_receive_any_until(const std::chrono::time_point<Clock, Duration>& abs_time,
+                                  Sources&&... sources)
+{
+    return detail::receive_any(detail::to_deadline(abs_time),
+                               std::make_tuple(detail::make_source(sources)...));
+}
+
 } // namespace zephyr
+
+/// @brief  Defines a signal that is initialized at compile time. Signals have no kernel
+///         object section, so it's a plain constinit definition.
+/// @param  name: the name of the signal variable
+#define ZEPHYR_SIGNAL_DEFINE(name) constinit ::zephyr::signal name{::zephyr::static_init}
@@ -0,0 +1,266 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include "zephyr/polling.hpp"
+#include "zephyr/work_queue.hpp"
+
+namespace zephyr
+{
+/// @brief  Event loop, running on the thread that calls @ref run, dispatching
+///         the handlers of its ready sources and expired timers.
+///         A single k_poll() call waits for all sources, and the nearest timer deadline.
+///         Each wake-up drains a batch from every ready source, so a busy source
+///         can't starve the others.
+///         Sources and timers are added before @ref run, or from the handlers.
+/// @tparam N: the maximal number of sources
+/// @tparam TIMERS: the maximal number of timers
+/// @tparam CAPACITY: the inline storage size of each handler, along with its source
+///         reference and batch size (two words)
+template <std::size_t N, std::size_t TIMERS = 4, std::size_t CAPACITY = 4 * sizeof(void*)>
+class reactor
+{
+  public:
+    static constexpr std::size_t default_batch = 8;
+
+    struct statistics
+    {
+        /// the number of loop wake-ups
+        std::uint32_t iterations{};
+        /// the number of handler invocations
+        std::uint32_t dispatched{};
+        /// the time spent dispatching in a single iteration, in hardware cycles
+        std::uint32_t max_iteration_cycles{};
+        std::uint64_t total_iteration_cycles{};
+        /// the delay of timer handlers after their deadlines
+        tick_timer::duration max_timer_lateness{tick_timer::duration::zero()};
+    };
+
+    reactor(const reactor&) = delete;
+    reactor& operator=(const reactor&) = delete;
+
+    reactor()
+    {
+        ::k_poll_signal_init(&wakeup_);
+        events_[0] = poll_event(wakeup_);
+    }
+
+    /// @brief  Adds a semaphore source, the handler is called for each acquisition.
+    /// @param  sem: the semaphore to acquire
+    /// @param  fn: the handler, invocable without arguments
+    /// @param  batch: the maximal number of acquisitions per wake-up
+    /// @return false if the reactor has no room for more sources
+    template <typename F>
+    bool add(::k_sem& sem, F&& fn, std::size_t batch = default_batch)
+    {
+        return add_source(poll_event(sem), [&sem, fn = std::forward<F>(fn), batch]() mutable {
+            for (std::size_t i = 0; (i < batch) and (::k_sem_take(&sem, K_NO_WAIT) == 0); ++i)
+            {
+                fn();
+            }
+        });
+    }
+
+    /// @brief  Adds a message queue source, the handler is called for each message.
+    /// @param  msgq: the message queue to receive from
+    /// @param  fn: the handler, invocable with a const T& message
+    /// @param  batch: the maximal number of messages received per wake-up
+    /// @return false if the reactor has no room for more sources
+    template <typename T, typename F>
+    bool add(message_queue<T>& msgq, F&& fn, std::size_t batch = default_batch)
+    {
+        return add_source(poll_event(msgq), [&msgq, fn = std::forward<F>(fn), batch]() mutable {
+            T msg;
+            for (std::size_t i = 0; (i < batch) and msgq.try_get(msg); ++i)
+            {
+                fn(static_cast<const T&>(msg));
+            }
+        });
+    }
+
+    /// @brief  Adds a signal source, the signal is reset before calling the handler.
+    /// @param  sig: the signal to wait for
+    /// @param  fn: the handler, invocable with the int result of the signal
+    /// @return false if the reactor has no room for more sources
+    template <typename F>
+    bool add(::k_poll_signal& sig, F&& fn)
+    {
+        return add_source(poll_event(sig), [&sig, fn = std::forward<F>(fn)]() mutable {
+            unsigned int signaled;
+            int result;
+            ::k_poll_signal_check(&sig, &signaled, &result);
+            if (signaled != 0U)
+            {
+                ::k_poll_signal_reset(&sig);
+                fn(result);
+            }
+        });
+    }
+
+    /// @brief  Starts a timer, dispatched by the loop when its deadline passes.
+    /// @param  period: the time until the (first) expiry
+    /// @param  fn: the handler, invocable without arguments
+    /// @param  periodic: whether the timer restarts at each expiry, periodic timers
+    ///         keep their phase, skipping the expiries missed by a late dispatch
+    /// @return the timer's identifier, or empty if the reactor has no room for more timers
+    template <class Rep, class Period, typename F>
+    std::optional<std::size_t> add_timer(const std::chrono::duration<Rep, Period>& period, F&& fn,
+                                         bool periodic = true)
+    {
+        for (std::size_t i = 0; i < TIMERS; ++i)
+        {
+            auto& t = timers_[i];
+            if (!t.armed() and (i != dispatching_timer_))
+            {
+                t.period = std::chrono::ceil<tick_timer::duration>(period);
+                t.periodic = periodic;
+                t.fn.emplace(std::forward<F>(fn));
+                t.deadline = tick_timer::now() + t.period;
+                wake();
+                return i;
+            }
+        }
+        return std::nullopt;
+    }
+
+    /// @brief  Stops a timer, its handler is no longer called.
+    /// @param  id: the timer's identifier
+    void cancel_timer(std::size_t id)
+    {
+        timers_[id].deadline = tick_timer::time_point::max();
+    }
+
+    /// @brief  Runs the loop on the calling thread until @ref stop is called.
+    /// @remark Thread context callable
+    void run()
+    {
+        while (run_once())
+        {
+        }
+    }
+
+    /// @brief  Waits for ready sources or expired timers, and dispatches their handlers.
+    /// @return false if the loop was stopped, true otherwise
+    /// @remark Thread context callable
+    bool run_once()
+    {
+        ::k_poll(events_.data(), static_cast<int>(count_ + 1),
+                 detail::deadline_timeout(next_deadline()));
+        const std::uint32_t start = ::k_cycle_get_32();
+        if (events_[0].state != K_POLL_STATE_NOT_READY)
+        {
+            events_[0].state = K_POLL_STATE_NOT_READY;
+            ::k_poll_signal_reset(&wakeup_);
+            if (stopping_.exchange(false, std::memory_order_relaxed))
+            {
+                return false;
+            }
+        }
+        for (std::size_t i = 0; i < count_; ++i)
+        {
+            auto& e = events_[i + 1];
+            if (e.state != K_POLL_STATE_NOT_READY)
+            {
+                e.state = K_POLL_STATE_NOT_READY;
+                handlers_[i]();
+                ++stats_.dispatched;
+            }
+        }
+        dispatch_timers();
+
+        const std::uint32_t cycles = ::k_cycle_get_32() - start;
+        ++stats_.iterations;
+        stats_.max_iteration_cycles = std::max(stats_.max_iteration_cycles, cycles);
+        stats_.total_iteration_cycles += cycles;
+        return true;
+    }
+
+    /// @brief  Makes @ref run return after the current iteration.
+    /// @remark Thread and ISR context callable
+    void stop()
+    {
+        stopping_.store(true, std::memory_order_relaxed);
+        wake();
+    }
+
+    const statistics& stats() const { return stats_; }
+    void reset_stats() { stats_ = {}; }
+
+  private:
+    struct timer
+    {
+        tick_timer::time_point deadline{tick_timer::time_point::max()};
+        tick_timer::duration period{};
+        bool periodic{};
+        detail::inline_function<CAPACITY> fn;
+
+        bool armed() const { return deadline != tick_timer::time_point::max(); }
+    };
+
+    static constexpr std::size_t no_timer = TIMERS;
+
+    template <typename F>
+    bool add_source(const poll_event& event, F&& fn)
+    {
+        if (count_ == N)
+        {
+            return false;
+        }
+        events_[count_ + 1] = event;
+        handlers_[count_].emplace(std::forward<F>(fn));
+        ++count_;
+        return true;
+    }
+
+    void wake() { ::k_poll_signal_raise(&wakeup_, 0); }
+
+    tick_timer::time_point next_deadline() const
+    {
+        auto next = tick_timer::time_point::max();
+        for (const auto& t : timers_)
+        {
+            next = std::min(next, t.deadline);
+        }
+        return next;
+    }
+
+    void dispatch_timers()
+    {
+        const auto now = tick_timer::now();
+        for (std::size_t i = 0; i < TIMERS; ++i)
+        {
+            auto& t = timers_[i];
+            if (!t.armed() or (t.deadline > now))
+            {
+                continue;
+            }
+            stats_.max_timer_lateness = std::max(stats_.max_timer_lateness, now - t.deadline);
+            if (t.periodic)
+            {
+                t.deadline += ((now - t.deadline) / t.period + 1) * t.period;
+            }
+            else
+            {
+                t.deadline = tick_timer::time_point::max();
+            }
+            dispatching_timer_ = i;
+            t.fn();
+            dispatching_timer_ = no_timer;
+            ++stats_.dispatched;
+        }
+    }
+
+    std::array<::k_poll_event, N + 1> events_{};
+    std::array<detail::inline_function<CAPACITY>, N> handlers_{};
+    std::array<timer, TIMERS> timers_{};
+    std::size_t count_{};
+    std::size_t dispatching_timer_{no_timer};
+    std::atomic<bool> stopping_{};
+    ::k_poll_signal wakeup_;
+    statistics stats_{};
+};
+
+} // namespace zephyr
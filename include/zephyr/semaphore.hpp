@@ -1,6 +1,11 @@
 // SPDX-License-Identifier: Apache-2.0
 #pragma once
+#include <zephyr/sys/atomic.h>
+#include "zephyr/cpu.hpp"
+#include "zephyr/static_init.hpp"
+#include "zephyr/stats.hpp"
 #include "zephyr/tick_timer.hpp"
+#include "zephyr/trace.hpp"
 
 namespace zephyr
 {
@@ -12,30 +17,186 @@ struct counting_semaphore final : public ::k_sem
         __ASSERT_NO_MSG((desired >= 0) and (desired <= COUNT));
         ::k_sem_init(this, desired, COUNT);
     }
+    /// @brief  Initializes the semaphore at compile time, see @ref ZEPHYR_SEMAPHORE_DEFINE.
+    ZEPHYR_MCPP_STATIC_CONSTEXPR counting_semaphore(static_init_t, std::ptrdiff_t desired)
+        : ::k_sem Z_SEM_INITIALIZER((*this), static_cast<unsigned int>(desired), COUNT)
+    {
+#ifndef CONFIG_ZEPHYR_MCPP_STATS
+        static_assert(detail::iterable_as<::k_sem, counting_semaphore>);
+#endif
+    }
+    /// @brief  Increments the count, releasing up to update waiting threads.
+    ///         The threads are released with the scheduler locked, so the caller is preempted
+    ///         at most once, not by each released thread in turn.
+    /// @param  update: the value to increment the count by
+    /// @remark Thread and ISR context callable
     void release(std::ptrdiff_t update = 1)
     {
         __ASSERT_NO_MSG(update >= 0);
+        trace::emit(trace::event::semaphore_release, trace::word(this),
+                    static_cast<std::uint32_t>(update));
+        if (update == 1)
+        {
+            ::k_sem_give(this);
+            return;
+        }
+        scheduler_lock lock;
         for (; update > 0; --update)
         {
             ::k_sem_give(this);
         }
     }
-    void acquire() { ::k_sem_take(this, K_FOREVER); }
-    bool try_acquire() { return ::k_sem_take(this, K_NO_WAIT) == 0; }
+    void acquire() { take(K_FOREVER); }
+    bool try_acquire() { return take(K_NO_WAIT) == 0; }
 
     template <class Rep, class Period>
     inline bool try_acquire_for(const std::chrono::duration<Rep, Period>& rel_time)
     {
-        return ::k_sem_take(this, to_timeout(rel_time)) == 0;
+        return take(to_timeout(rel_time)) == 0;
     }
 
     template <class Clock, class Duration>
     inline bool try_acquire_until(const std::chrono::time_point<Clock, Duration>& abs_time)
     {
-        return try_acquire_for(duration_until(abs_time));
+        return take(timeout_until(abs_time)) == 0;
+    }
+
+#ifdef CONFIG_ZEPHYR_MCPP_STATS
+    const wait_stats& stats() const { return stats_; }
+    wait_stats& stats() { return stats_; }
+
+  private:
+    int take(k_timeout_t timeout)
+    {
+        const wait_stats::stopwatch sw;
+        const trace::span span;
+        const int status = ::k_sem_take(this, timeout);
+        span.end(trace::event::semaphore_acquire, this, status);
+        stats_.record(sw.elapsed(), status == 0);
+        return status;
     }
+
+    wait_stats stats_{wait_stats::object_kind::semaphore, this};
+#else
+  private:
+    int take(k_timeout_t timeout)
+    {
+        const trace::span span;
+        const int status = ::k_sem_take(this, timeout);
+        span.end(trace::event::semaphore_acquire, this, status);
+        return status;
+    }
+#endif
 };
 
 using binary_semaphore = counting_semaphore<1>;
 
+/// @brief  Counting semaphore that is acquired and released with atomic operations
+///         on its own memory, and only calls into the kernel (k_futex_wait/k_futex_wake)
+///         to block a thread on a zero count, or to wake one up. This saves the system calls
+///         of the uncontended operations in user mode threads.
+///         Requires CONFIG_USERSPACE. The object must be a kernel object: statically defined
+///         (so that the kernel object generator finds it), or allocated with k_object_alloc();
+///         granting the user threads access to its memory alone isn't enough.
+template <std::ptrdiff_t COUNT>
+class fast_semaphore
+{
+  public:
+    fast_semaphore(const fast_semaphore&) = delete;
+    fast_semaphore& operator=(const fast_semaphore&) = delete;
+
+    explicit fast_semaphore(std::ptrdiff_t desired)
+    {
+        __ASSERT_NO_MSG((desired >= 0) and (desired <= COUNT));
+        futex_.val = desired;
+    }
+
+    /// @remark Thread context callable
+    void release(std::ptrdiff_t update = 1)
+    {
+        __ASSERT_NO_MSG(update >= 0);
+        [[maybe_unused]] const ::atomic_val_t previous = ::atomic_add(&futex_.val, update);
+        __ASSERT_NO_MSG(previous + update <= COUNT);
+        if (::atomic_get(&waiters_) > 0)
+        {
+            ::k_futex_wake(&futex_, update > 1);
+        }
+    }
+
+    /// @remark Thread context callable
+    void acquire()
+    {
+        if (!try_acquire())
+        {
+            take_contended(tick_timer::time_point::max());
+        }
+    }
+
+    /// @remark Thread context callable
+    bool try_acquire()
+    {
+        for (::atomic_val_t count = ::atomic_get(&futex_.val); count > 0;
+             count = ::atomic_get(&futex_.val))
+        {
+            if (::atomic_cas(&futex_.val, count, count - 1))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @remark Thread context callable
+    template <class Rep, class Period>
+    bool try_acquire_for(const std::chrono::duration<Rep, Period>& rel_time)
+    {
+        return try_acquire() or take_contended(detail::to_deadline(rel_time));
+    }
+
+    /// @remark Thread context callable
+    template <class Clock, class Duration>
+    bool try_acquire_until(const std::chrono::time_point<Clock, Duration>& abs_time)
+    {
+        return try_acquire() or take_contended(detail::to_deadline(abs_time));
+    }
+
+  private:
+    bool take_contended(const tick_timer::time_point& deadline)
+    {
+        // the waiter is counted before checking the count once more, and the releasing thread
+        // checks the waiters after raising the count, so one of them notices the other
+        ::atomic_inc(&waiters_);
+        bool acquired;
+        while (!(acquired = try_acquire()))
+        {
+            const int err = ::k_futex_wait(&futex_, 0, detail::deadline_timeout(deadline));
+            // -EINVAL means that the futex isn't a kernel object, retrying would spin forever
+            __ASSERT((err == 0) or (err == -EAGAIN) or (err == -ETIMEDOUT),
+                     "k_futex_wait failed: %d", err);
+            if ((err != 0) and (err != -EAGAIN))
+            {
+                break;
+            }
+        }
+        ::atomic_dec(&waiters_);
+        return acquired;
+    }
+
+    ::k_futex futex_{};
+    ::atomic_t waiters_{};
+};
+
+using fast_binary_semaphore = fast_semaphore<1>;
+
 } // namespace zephyr
+
+/// @brief  Defines a counting_semaphore that is initialized at compile time, and placed
+///         in the kernel's semaphore section, like K_SEM_DEFINE.
+/// @param  name: the name of the semaphore variable
+/// @param  max: the maximal count of the semaphore
+/// @param  desired: the initial count of the semaphore
+#define ZEPHYR_SEMAPHORE_DEFINE(name, max, desired)                                                \
+    ZEPHYR_MCPP_STATIC_OBJECT(k_sem, ::zephyr::counting_semaphore<max>, name)                      \
+    {                                                                                              \
+        ::zephyr::static_init, desired                                                             \
+    }
@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+#include <zephyr/kernel.h>
+#include <zephyr/sys/iterable_sections.h>
+
+namespace zephyr
+{
+/// @brief  Tag selecting the constexpr constructors of the kernel object wrappers,
+///         which initialize the kernel object at compile time, like the K_*_DEFINE macros do.
+///         Use them through the ZEPHYR_*_DEFINE macros, or with constinit definitions.
+struct static_init_t
+{
+    explicit constexpr static_init_t() = default;
+};
+
+inline constexpr static_init_t static_init{};
+
+namespace detail
+{
+/// @brief  The kernel iterates its object sections as arrays of the C type,
+///         so the wrappers placed there must not add any members.
+template <typename KObj, typename T>
+inline constexpr bool iterable_as = (sizeof(T) == sizeof(KObj)) and (alignof(T) == alignof(KObj));
+} // namespace detail
+
+} // namespace zephyr
+
+#ifdef CONFIG_ZEPHYR_MCPP_STATS
+// the wait statistics of the object are registered at runtime, and they don't fit
+// in the kernel object's section either
+#define ZEPHYR_MCPP_STATIC_CONSTEXPR
+#define ZEPHYR_MCPP_STATIC_CONSTINIT
+#define ZEPHYR_MCPP_STATIC_OBJECT(kobj, type, name) type name
+#else
+#define ZEPHYR_MCPP_STATIC_CONSTEXPR constexpr
+#define ZEPHYR_MCPP_STATIC_CONSTINIT constinit
+#define ZEPHYR_MCPP_STATIC_OBJECT(kobj, type, name)                                                \
+    constinit TYPE_SECTION_ITERABLE(type, name, kobj, name)
+#endif
@@ -0,0 +1,153 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+#include "zephyr/tick_timer.hpp"
+
+#ifdef CONFIG_ZEPHYR_MCPP_STATS
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <zephyr/spinlock.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/slist.h>
+
+namespace zephyr
+{
+/// @brief  Wait statistics of a synchronization object, enabled by CONFIG_ZEPHYR_MCPP_STATS.
+///         Every instance is listed in a registry for the lifetime of its object,
+///         see @ref for_each.
+class wait_stats
+{
+  public:
+    enum class object_kind : std::uint8_t
+    {
+        semaphore,
+        mutex,
+        message_queue,
+        event_group,
+        spinlock,
+    };
+
+    /// @brief  The wait times are counted in buckets of powers of two hardware cycles:
+    ///         bucket 0 holds the waits of 0 cycles, bucket N of [2^(N-1), 2^N) cycles.
+    static constexpr std::size_t histogram_size = 32;
+
+    /// @brief  Measures the wait time of a single operation.
+    class stopwatch
+    {
+      public:
+        stopwatch() : start_(::k_cycle_get_32()) {}
+        std::uint32_t elapsed() const { return ::k_cycle_get_32() - start_; }
+
+      private:
+        std::uint32_t start_;
+    };
+
+    wait_stats(object_kind kind, const void* object) : kind_(kind), object_(object)
+    {
+        const ::k_spinlock_key_t key = ::k_spin_lock(&registry_lock_);
+        ::sys_slist_append(&registry_, &node_);
+        ::k_spin_unlock(&registry_lock_, key);
+    }
+    ~wait_stats()
+    {
+        const ::k_spinlock_key_t key = ::k_spin_lock(&registry_lock_);
+        ::sys_slist_find_and_remove(&registry_, &node_);
+        ::k_spin_unlock(&registry_lock_, key);
+    }
+    wait_stats(const wait_stats&) = delete;
+    wait_stats& operator=(const wait_stats&) = delete;
+
+    /// @brief  Records the outcome of a wait operation.
+    /// @param  cycles: the time spent in the operation
+    /// @param  success: false if the operation timed out (or failed without waiting)
+    /// @remark Thread and ISR context callable
+    void record(std::uint32_t cycles, bool success)
+    {
+        ::atomic_inc(&waits_);
+        if (!success)
+        {
+            ::atomic_inc(&timeouts_);
+        }
+        const auto bucket = std::min<std::size_t>(std::bit_width(cycles), histogram_size - 1);
+        ::atomic_inc(&histogram_[bucket]);
+    }
+
+    /// @brief  Records the current fill level of a queue.
+    /// @param  level: the number of items in the queue
+    /// @remark Thread and ISR context callable
+    void record_level(std::size_t level)
+    {
+        const auto value = static_cast<::atomic_val_t>(level);
+        for (::atomic_val_t high = ::atomic_get(&high_water_); value > high;
+             high = ::atomic_get(&high_water_))
+        {
+            if (::atomic_cas(&high_water_, high, value))
+            {
+                break;
+            }
+        }
+    }
+
+    object_kind kind() const { return kind_; }
+    /// @brief  The address of the object that the statistics belong to.
+    const void* object() const { return object_; }
+    const char* name() const { return name_; }
+    void set_name(const char* name) { name_ = name; }
+
+    /// @brief  The number of wait operations (including the ones that didn't block).
+    std::uint32_t waits() const { return load(waits_); }
+    /// @brief  The number of wait operations that ended without success.
+    std::uint32_t timeouts() const { return load(timeouts_); }
+    /// @brief  The highest recorded fill level (only recorded by queues).
+    std::uint32_t high_water() const { return load(high_water_); }
+    /// @brief  The number of waits that lasted [2^(bucket-1), 2^bucket) cycles.
+    std::uint32_t histogram(std::size_t bucket) const { return load(histogram_[bucket]); }
+
+    /// @brief  Restarts the statistics collection.
+    void reset()
+    {
+        ::atomic_clear(&waits_);
+        ::atomic_clear(&timeouts_);
+        ::atomic_clear(&high_water_);
+        for (auto& bucket : histogram_)
+        {
+            ::atomic_clear(&bucket);
+        }
+    }
+
+    /// @brief  Calls the function with each registered statistics instance.
+    ///         The registry is locked meanwhile, so the function must not block.
+    /// @param  fn: callable with a const wait_stats& parameter
+    template <typename F>
+    static void for_each(F&& fn)
+    {
+        const ::k_spinlock_key_t key = ::k_spin_lock(&registry_lock_);
+        ::sys_snode_t* node;
+        SYS_SLIST_FOR_EACH_NODE(&registry_, node)
+        {
+            fn(static_cast<const wait_stats&>(*CONTAINER_OF(node, wait_stats, node_)));
+        }
+        ::k_spin_unlock(&registry_lock_, key);
+    }
+
+  private:
+    static std::uint32_t load(const ::atomic_t& value)
+    {
+        return static_cast<std::uint32_t>(::atomic_get(&value));
+    }
+
+    static inline ::sys_slist_t registry_{};
+    static inline ::k_spinlock registry_lock_{};
+
+    ::sys_snode_t node_{};
+    object_kind kind_;
+    const void* object_;
+    const char* name_{};
+    ::atomic_t waits_{};
+    ::atomic_t timeouts_{};
+    ::atomic_t high_water_{};
+    ::atomic_t histogram_[histogram_size]{};
+};
+
+} // namespace zephyr
+#endif // CONFIG_ZEPHYR_MCPP_STATS
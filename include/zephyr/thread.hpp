@@ -1,7 +1,11 @@
 // SPDX-License-Identifier: Apache-2.0
 #pragma once
 #include "zephyr/tick_timer.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
 #include <system_error>
+#include <type_traits>
 #include <zephyr/kernel.h>
 
 namespace zephyr
@@ -28,9 +32,71 @@ class thread final : public ::k_thread
         return std::errc(::k_thread_join(this, to_timeout(timeout)));
     }
 
+    /// @brief  Starts a thread that was created with infinite delay.
+    void start() { ::k_thread_start(this); }
     void suspend() { ::k_thread_suspend(this); }
     void resume() { ::k_thread_resume(this); }
 
+#ifdef CONFIG_SCHED_CPU_MASK
+    /// @brief  Restricts the thread to run on the given CPU only.
+    ///         The CPU mask of a thread can only be changed while it isn't runnable.
+    /// @param  cpu: the index of the CPU
+    /// @return error code, success if the thread was pinned
+    auto pin_to_cpu(int cpu)
+    {
+        const int err = ::k_thread_cpu_mask_clear(this);
+        return std::errc(err != 0 ? err : ::k_thread_cpu_mask_enable(this, cpu));
+    }
+    auto cpu_mask_enable(int cpu) { return std::errc(::k_thread_cpu_mask_enable(this, cpu)); }
+    auto cpu_mask_disable(int cpu) { return std::errc(::k_thread_cpu_mask_disable(this, cpu)); }
+    auto cpu_mask_enable_all() { return std::errc(::k_thread_cpu_mask_enable_all(this)); }
+#endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+    /// @brief  Sets the thread's deadline relative to now. Among the ready threads
+    ///         of the same priority, the one with the earliest deadline runs first (EDF).
+    /// @param  rel_deadline: the time until the deadline
+    template <class Rep, class Period>
+    void set_deadline(const std::chrono::duration<Rep, Period>& rel_deadline)
+    {
+        const auto ns = std::max(std::chrono::ceil<std::chrono::nanoseconds>(rel_deadline),
+                                 std::chrono::nanoseconds::zero());
+        const auto cycles = ::k_ns_to_cyc_ceil64(static_cast<std::uint64_t>(ns.count()));
+        ::k_thread_deadline_set(this, static_cast<int>(std::min<std::uint64_t>(cycles, INT_MAX)));
+    }
+#endif
+
+#ifdef CONFIG_SCHED_THREAD_USAGE
+    /// @brief  The total time the thread has been executing, in hardware cycles.
+    std::uint64_t runtime_cycles() const
+    {
+        ::k_thread_runtime_stats_t stats{};
+        ::k_thread_runtime_stats_get(const_cast<thread*>(this), &stats);
+        return stats.execution_cycles;
+    }
+
+    /// @brief  The total time the thread has been executing.
+    tick_timer::duration runtime() const
+    {
+        return tick_timer::duration(::k_cyc_to_ticks_floor64(runtime_cycles()));
+    }
+#endif
+
+#ifdef CONFIG_THREAD_STACK_INFO
+    std::size_t stack_size() const { return stack_info.size; }
+
+#ifdef CONFIG_INIT_STACKS
+    /// @brief  Measures the stack space that the thread has never used,
+    ///         by scanning the stack from its far end for the initial fill pattern.
+    /// @return the unused stack size in bytes, 0 if it can't be determined
+    std::size_t stack_unused() const
+    {
+        std::size_t unused = 0;
+        return ::k_thread_stack_space_get(this, &unused) == 0 ? unused : 0;
+    }
+#endif
+#endif
+
     void abort() { ::k_thread_abort(this); }
 
     template <size_t STACK_SIZE, class Rep = tick_timer::rep, class Period = tick_timer::period>
@@ -78,8 +144,101 @@ inline void sleep_for(const std::chrono::duration<Rep, Period>& rel_time)
 template <class Clock, class Duration>
 inline void sleep_until(const std::chrono::time_point<Clock, Duration>& abs_time)
 {
-    sleep_for(duration_until(abs_time));
+    ::k_sleep(timeout_until(abs_time));
 }
 
 } // namespace this_thread
+
+#ifdef CONFIG_THREAD_MONITOR
+/// @brief  Calls the function for each thread of the system. The thread list is locked
+///         meanwhile, so the function must not block, or create and abort threads.
+/// @param  fn: callable with a const thread& parameter
+template <typename F>
+inline void for_each_thread(F&& fn)
+{
+    ::k_thread_foreach(
+        [](const ::k_thread* t, void* user) {
+            (*static_cast<std::remove_reference_t<F>*>(user))(*static_cast<const thread*>(t));
+        },
+        &fn);
+}
+#endif
+
+/// @brief  Drives a fixed rate loop by sleeping until absolute, evenly spaced deadlines,
+///         so the loop doesn't drift by its own execution time or preemptions.
+///         When an iteration overruns its period, the missed activations are skipped
+///         to keep the loop phase-locked to its start time.
+class periodic
+{
+  public:
+    struct statistics
+    {
+        std::uint32_t activations{};
+        std::uint32_t overruns{};
+        std::uint32_t skipped{};
+        tick_timer::duration min_lateness{tick_timer::duration::max()};
+        tick_timer::duration max_lateness{tick_timer::duration::zero()};
+        tick_timer::duration total_lateness{tick_timer::duration::zero()};
+
+        /// @brief  The spread of the wake-up times around the deadlines.
+        tick_timer::duration jitter() const
+        {
+            return activations > 0 ? max_lateness - min_lateness : tick_timer::duration::zero();
+        }
+        tick_timer::duration mean_lateness() const
+        {
+            return activations > 0 ? total_lateness / activations : tick_timer::duration::zero();
+        }
+    };
+
+    /// @brief  Sets up the loop timing, the first activation is one period after the start.
+    /// @param  period: the time between activations
+    /// @param  start: the phase reference of the activations
+    template <class Rep, class Period>
+    explicit periodic(const std::chrono::duration<Rep, Period>& period,
+                      tick_timer::time_point start = tick_timer::now())
+        : period_(std::chrono::ceil<tick_timer::duration>(period)), next_(start + period_)
+    {
+        __ASSERT_NO_MSG(period_ > tick_timer::duration::zero());
+    }
+
+    /// @brief  Blocks the current thread until the next activation.
+    /// @return true if the previous iteration completed within its period,
+    ///         false if it overran, and activations were skipped
+    /// @remark Thread context callable
+    bool wait()
+    {
+        const auto now = tick_timer::now();
+        const bool on_time = now < next_;
+        if (!on_time)
+        {
+            const auto missed = static_cast<std::uint32_t>((now - next_) / period_) + 1;
+            next_ += missed * period_;
+            ++stats_.overruns;
+            stats_.skipped += missed;
+        }
+        this_thread::sleep_until(next_);
+
+        const auto lateness = tick_timer::now() - next_;
+        stats_.min_lateness = std::min(stats_.min_lateness, lateness);
+        stats_.max_lateness = std::max(stats_.max_lateness, lateness);
+        stats_.total_lateness += lateness;
+        ++stats_.activations;
+        next_ += period_;
+        return on_time;
+    }
+
+    /// @brief  The deadline of the next activation.
+    tick_timer::time_point next_activation() const { return next_; }
+    tick_timer::duration period() const { return period_; }
+
+    const statistics& stats() const { return stats_; }
+    void reset_stats() { stats_ = {}; }
+
+  private:
+    tick_timer::duration period_;
+    tick_timer::time_point next_;
+    statistics stats_{};
+};
+
 } // namespace zephyr
@@ -0,0 +1,369 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include "zephyr/cpu.hpp"
+#include "zephyr/semaphore.hpp"
+#include "zephyr/thread.hpp"
+#include "zephyr/work_queue.hpp"
+
+namespace zephyr
+{
+template <std::size_t WORKERS, std::size_t STACK_SIZE, std::size_t DEQUE_SIZE>
+class thread_pool;
+
+/// @brief  Intrusive job of a @ref thread_pool. The job must stay alive, and must not be
+///         submitted again until it has run.
+class pool_job
+{
+  public:
+    explicit pool_job(void (*fn)(pool_job*)) : fn_(fn) {}
+    pool_job(const pool_job&) = delete;
+    pool_job& operator=(const pool_job&) = delete;
+
+  private:
+    template <std::size_t WORKERS, std::size_t STACK_SIZE, std::size_t DEQUE_SIZE>
+    friend class thread_pool;
+
+    ::sys_snode_t node_{};
+    void (*fn_)(pool_job*);
+};
+
+/// @brief  Thread pool job that runs the callable (e.g. a capturing lambda)
+///         it was constructed with.
+/// @tparam CAPACITY: the inline storage size of the callable
+template <std::size_t CAPACITY = 2 * sizeof(void*)>
+class callable_job final : public pool_job
+{
+  public:
+    template <typename F>
+    explicit callable_job(F&& fn) : pool_job(&invoke), fn_(std::forward<F>(fn))
+    {}
+
+  private:
+    static void invoke(pool_job* j) { static_cast<callable_job*>(j)->fn_(); }
+
+    detail::inline_function<CAPACITY> fn_;
+};
+
+namespace detail
+{
+/// @brief  Chase-Lev work-stealing deque of job pointers, with fixed capacity.
+///         The owner pushes and pops at the bottom, other threads steal from the top.
+template <typename T, std::size_t CAPACITY>
+class stealing_deque
+{
+    static_assert((CAPACITY > 0) and ((CAPACITY & (CAPACITY - 1)) == 0),
+                  "the capacity must be a power of 2");
+    static constexpr std::size_t mask = CAPACITY - 1;
+    using difference = std::make_signed_t<std::size_t>;
+
+  public:
+    /// @brief  Owner only.
+    /// @return false if the deque is full
+    bool push(T* item)
+    {
+        const std::size_t b = bottom_.load(std::memory_order_relaxed);
+        const std::size_t t = top_.load(std::memory_order_acquire);
+        if ((b - t) >= CAPACITY)
+        {
+            return false;
+        }
+        slots_[b & mask].store(item, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /// @brief  Owner only, takes the most recently pushed item.
+    T* pop()
+    {
+        const std::size_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::size_t t = top_.load(std::memory_order_relaxed);
+        if (static_cast<difference>(b - t) < 0)
+        {
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        T* item = slots_[b & mask].load(std::memory_order_relaxed);
+        if (t == b)
+        {
+            // last item, race the thieves for it
+            if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                              std::memory_order_relaxed))
+            {
+                item = nullptr;
+            }
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    /// @brief  Any thread, takes the least recently pushed item.
+    T* steal()
+    {
+        for (;;)
+        {
+            std::size_t t = top_.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const std::size_t b = bottom_.load(std::memory_order_acquire);
+            if (static_cast<difference>(b - t) <= 0)
+            {
+                return nullptr;
+            }
+            T* item = slots_[t & mask].load(std::memory_order_relaxed);
+            if (top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                             std::memory_order_relaxed))
+            {
+                return item;
+            }
+        }
+    }
+
+  private:
+    alignas(cache_line_size) std::atomic<std::size_t> top_{};
+    alignas(cache_line_size) std::atomic<std::size_t> bottom_{};
+    std::atomic<T*> slots_[CAPACITY]{};
+};
+} // namespace detail
+
+/// @brief  Pool of worker threads, each pinned to a CPU (with CONFIG_SCHED_CPU_MASK) in turn.
+///         Jobs submitted by a worker go to its own deque, other submissions to a shared queue,
+///         idle workers steal jobs from the busy ones' deques.
+/// @tparam WORKERS: the number of worker threads, typically the number of CPUs
+/// @tparam STACK_SIZE: the stack size of each worker thread
+/// @tparam DEQUE_SIZE: the job capacity of each worker's deque, overflowing jobs
+///         go to the shared queue
+template <std::size_t WORKERS, std::size_t STACK_SIZE, std::size_t DEQUE_SIZE = 64>
+class thread_pool
+{
+    static_assert(WORKERS > 0);
+
+  public:
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    /// @brief  Starts the worker threads.
+    /// @param  prio: the priority of the worker threads
+    /// @param  name: the name of the worker threads
+    explicit thread_pool(zephyr::thread::priority prio, const char* name = nullptr)
+        : thread_pool(prio, std::make_index_sequence<WORKERS>{})
+    {
+        ::sys_slist_init(&shared_);
+        for (std::size_t i = 0; i < WORKERS; ++i)
+        {
+            auto& t = workers_[i].thread_;
+            if (name != nullptr)
+            {
+                t.set_name(name);
+            }
+#ifdef CONFIG_SCHED_CPU_MASK
+            t.pin_to_cpu(static_cast<int>(i % ::arch_num_cpus()));
+#endif
+            t.start();
+        }
+    }
+
+    /// @brief  Stops the workers once they have run out of jobs.
+    ~thread_pool()
+    {
+        stopping_.store(true, std::memory_order_relaxed);
+        pending_.release(WORKERS);
+        for (auto& w : workers_)
+        {
+            w.thread_.join(infinity);
+        }
+    }
+
+    /// @brief  Queues the job to be run by one of the workers.
+    /// @param  job: the job to run, must not be queued already
+    /// @remark Thread and ISR context callable
+    void submit(pool_job& job)
+    {
+        auto* self = current_worker();
+        if ((self == nullptr) or !self->deque_.push(&job))
+        {
+            critical_section cs(lock_);
+            ::sys_slist_append(&shared_, &job.node_);
+        }
+        pending_.release();
+    }
+
+    /// @brief  Calls the function for each index of the range, spreading the range
+    ///         over the workers and the calling thread, in chunks of the grain size.
+    ///         Blocks until all calls have returned.
+    /// @param  begin: the first index
+    /// @param  end: the index past the last one
+    /// @param  fn: callable with a std::size_t index parameter
+    /// @param  grain: the number of consecutive indexes to claim at once
+    /// @remark Thread context callable
+    template <typename F>
+    void parallel_for(std::size_t begin, std::size_t end, F&& fn, std::size_t grain = 1)
+    {
+        if (begin >= end)
+        {
+            return;
+        }
+        grain = std::max<std::size_t>(grain, 1);
+        const std::size_t chunks = (end - begin + grain - 1) / grain;
+        const std::size_t helpers = std::min(WORKERS, chunks - 1);
+
+        range_context<std::remove_reference_t<F>> ctx{fn, begin, end, grain, helpers + 1};
+        range_job<std::remove_reference_t<F>> jobs[WORKERS]{};
+        for (std::size_t i = 0; i < helpers; ++i)
+        {
+            jobs[i].ctx = &ctx;
+            submit(jobs[i]);
+        }
+        ctx.run();
+
+        // the last finishing job releases done, and it doesn't touch ctx afterwards
+        if (auto* self = current_worker(); self != nullptr)
+        {
+            // keep running jobs, the helper jobs may be queued behind this one
+            while (!ctx.done.try_acquire())
+            {
+                if (auto* job = find_job(*self); job != nullptr)
+                {
+                    job->fn_(job);
+                }
+                else if (ctx.done.try_acquire_for(tick_timer::duration{1}))
+                {
+                    break;
+                }
+            }
+        }
+        else
+        {
+            ctx.done.acquire();
+        }
+    }
+
+  private:
+    struct worker
+    {
+        worker(thread_pool& pool, zephyr::thread::priority prio)
+            : thread_(stack_, &run, this, &pool, nullptr, prio, 0, infinity)
+        {}
+        worker(const worker&) = delete;
+        worker& operator=(const worker&) = delete;
+
+        detail::stealing_deque<pool_job, DEQUE_SIZE> deque_;
+        zephyr::thread thread_;
+        K_KERNEL_STACK_MEMBER(stack_, STACK_SIZE);
+    };
+
+    template <typename F>
+    struct range_context
+    {
+        F& fn;
+        std::atomic<std::size_t> next;
+        const std::size_t end;
+        const std::size_t grain;
+        std::atomic<std::size_t> active;
+        binary_semaphore done{0};
+
+        void run()
+        {
+            for (std::size_t i; (i = next.fetch_add(grain, std::memory_order_relaxed)) < end;)
+            {
+                for (const std::size_t last = std::min(i + grain, end); i < last; ++i)
+                {
+                    fn(i);
+                }
+            }
+            if (active.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                done.release();
+            }
+        }
+    };
+
+    template <typename F>
+    struct range_job : public pool_job
+    {
+        range_job() : pool_job(&invoke) {}
+        static void invoke(pool_job* j) { static_cast<range_job*>(j)->ctx->run(); }
+
+        range_context<F>* ctx{};
+    };
+
+    template <std::size_t... I>
+    thread_pool(zephyr::thread::priority prio, std::index_sequence<I...>)
+        : workers_{((void)I, worker(*this, prio))...}
+    {}
+
+    worker* current_worker()
+    {
+        if (this_cpu::is_in_isr())
+        {
+            return nullptr;
+        }
+        const auto* current = ::k_current_get();
+        for (auto& w : workers_)
+        {
+            if (current == &w.thread_)
+            {
+                return &w;
+            }
+        }
+        return nullptr;
+    }
+
+    pool_job* find_job(worker& self)
+    {
+        if (auto* job = self.deque_.pop(); job != nullptr)
+        {
+            return job;
+        }
+        {
+            critical_section cs(lock_);
+            if (auto* node = ::sys_slist_get(&shared_); node != nullptr)
+            {
+                return CONTAINER_OF(node, pool_job, node_);
+            }
+        }
+        // start stealing at the next worker, to spread the thieves
+        const std::size_t index = &self - workers_;
+        for (std::size_t i = 1; i < WORKERS; ++i)
+        {
+            if (auto* job = workers_[(index + i) % WORKERS].deque_.steal(); job != nullptr)
+            {
+                return job;
+            }
+        }
+        return nullptr;
+    }
+
+    static void run(void* p1, void* p2, void*)
+    {
+        auto& self = *static_cast<worker*>(p1);
+        auto& pool = *static_cast<thread_pool*>(p2);
+        for (;;)
+        {
+            pool.pending_.acquire();
+            while (auto* job = pool.find_job(self))
+            {
+                job->fn_(job);
+            }
+            if (pool.stopping_.load(std::memory_order_relaxed))
+            {
+                return;
+            }
+        }
+    }
+
+    worker workers_[WORKERS];
+    counting_semaphore<INT_MAX> pending_{0};
+    std::atomic<bool> stopping_{};
+    ::sys_slist_t shared_;
+    spinlock lock_{};
+};
+
+} // namespace zephyr
@@ -0,0 +1,187 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include "zephyr/thread.hpp"
+
+namespace zephyr
+{
+/// @brief  Measures the CPU utilization of each thread (and with CONFIG_SCHED_THREAD_USAGE_ALL,
+///         of each CPU) over the window between two consecutive @ref sample calls.
+///         Requires CONFIG_SCHED_THREAD_USAGE and CONFIG_THREAD_MONITOR.
+/// @tparam MAX_THREADS: the maximal number of threads tracked, the rest are left out
+template <std::size_t MAX_THREADS>
+class thread_profiler
+{
+  public:
+#ifdef CONFIG_MP_MAX_NUM_CPUS
+    static constexpr std::size_t max_cpus = CONFIG_MP_MAX_NUM_CPUS;
+#else
+    static constexpr std::size_t max_cpus = 1;
+#endif
+
+    struct thread_usage
+    {
+        /// identifies the thread, it may have exited since the sample
+        const zephyr::thread* thread;
+        const char* name;
+        /// the time the thread was executing during the window
+        std::uint64_t cycles;
+        /// the utilization of a single CPU by the thread, in 1/1000
+        std::uint32_t permille;
+#ifdef CONFIG_SCHED_THREAD_USAGE_ANALYSIS
+        /// the number of times the thread was switched in during the window
+        std::uint32_t switches;
+#endif
+#ifdef CONFIG_THREAD_STACK_INFO
+        std::size_t stack_size;
+#ifdef CONFIG_INIT_STACKS
+        /// the stack space that the thread has never used
+        std::size_t stack_unused;
+#endif
+#endif
+    };
+
+    struct cpu_usage
+    {
+        /// the non-idle time of the CPU during the window
+        std::uint64_t busy_cycles;
+        /// the utilization of the CPU, in 1/1000
+        std::uint32_t permille;
+    };
+
+    thread_profiler(const thread_profiler&) = delete;
+    thread_profiler& operator=(const thread_profiler&) = delete;
+
+    /// @brief  Starts the first sampling window.
+    thread_profiler() { sample(); }
+
+    /// @brief  Closes the current sampling window, computing the utilizations,
+    ///         and starts the next window. The thread list is walked unlocked
+    ///         (like the kernel shell does), as scanning the stacks takes long.
+    /// @remark Thread context callable
+    void sample()
+    {
+        const auto now = tick_timer::now();
+        window_cycles_ = std::max<std::uint64_t>(
+            ::k_ticks_to_cyc_floor64(static_cast<std::uint64_t>(to_ticks(now - last_sample_))), 1);
+        last_sample_ = now;
+
+        count_ = 0;
+        truncated_ = false;
+        ::k_thread_foreach_unlocked(&visit, this);
+        std::swap(last_, next_);
+        last_count_ = count_;
+
+#ifdef CONFIG_SCHED_THREAD_USAGE_ALL
+        for (unsigned int i = 0; i < cpus(); ++i)
+        {
+            ::k_thread_runtime_stats_t stats{};
+            ::k_thread_runtime_stats_cpu_get(static_cast<int>(i), &stats);
+            auto& last = cpu_last_[i];
+            const std::uint64_t busy = stats.total_cycles - last.busy;
+            const std::uint64_t all = std::max<std::uint64_t>(stats.execution_cycles - last.all, 1);
+            cpus_[i] = {busy, static_cast<std::uint32_t>(busy * 1000 / all)};
+            last = {stats.total_cycles, stats.execution_cycles};
+        }
+#endif
+    }
+
+    /// @brief  Calls the function with the usage of each thread in the last window.
+    /// @param  fn: callable with a const thread_usage& parameter
+    template <typename F>
+    void for_each_thread(F&& fn) const
+    {
+        std::for_each(usage_.begin(), usage_.begin() + count_, std::forward<F>(fn));
+    }
+
+    /// @brief  The number of threads sampled.
+    std::size_t size() const { return count_; }
+    /// @brief  Whether there were more threads than MAX_THREADS in the last sample.
+    bool truncated() const { return truncated_; }
+    /// @brief  The length of the last window, in hardware cycles.
+    std::uint64_t window_cycles() const { return window_cycles_; }
+
+#ifdef CONFIG_SCHED_THREAD_USAGE_ALL
+    static unsigned int cpus() { return std::min<unsigned int>(::arch_num_cpus(), max_cpus); }
+
+    /// @brief  The usage of a CPU in the last window.
+    /// @param  index: the CPU index, below @ref cpus
+    const cpu_usage& cpu(unsigned int index) const { return cpus_[index]; }
+#endif
+
+  private:
+    struct counters
+    {
+        const ::k_thread* id;
+        std::uint64_t cycles;
+        std::uint32_t windows;
+    };
+
+    static void visit(const ::k_thread* t, void* user)
+    {
+        static_cast<thread_profiler*>(user)->add(*static_cast<const zephyr::thread*>(t));
+    }
+
+    void add(const zephyr::thread& t)
+    {
+        if (count_ == MAX_THREADS)
+        {
+            truncated_ = true;
+            return;
+        }
+        ::k_thread_runtime_stats_t stats{};
+        ::k_thread_runtime_stats_get(const_cast<zephyr::thread*>(&t), &stats);
+        counters current{&t, stats.execution_cycles, 0};
+#ifdef CONFIG_SCHED_THREAD_USAGE_ANALYSIS
+        current.windows = t.base.usage.num_windows;
+#endif
+        // a thread is new to this window if its id wasn't seen, or its counters restarted
+        counters previous{&t, 0, 0};
+        const auto* last = std::find_if(last_.begin(), last_.begin() + last_count_,
+                                        [&t](const counters& c) { return c.id == &t; });
+        if ((last != last_.begin() + last_count_) and (last->cycles <= current.cycles))
+        {
+            previous = *last;
+        }
+
+        auto& u = usage_[count_];
+        u.thread = &t;
+        u.name = t.get_name();
+        u.cycles = current.cycles - previous.cycles;
+        u.permille = static_cast<std::uint32_t>(std::min<std::uint64_t>(
+            u.cycles * 1000 / window_cycles_, 1000));
+#ifdef CONFIG_SCHED_THREAD_USAGE_ANALYSIS
+        u.switches = current.windows - previous.windows;
+#endif
+#ifdef CONFIG_THREAD_STACK_INFO
+        u.stack_size = t.stack_size();
+#ifdef CONFIG_INIT_STACKS
+        u.stack_unused = t.stack_unused();
+#endif
+#endif
+        next_[count_] = current;
+        ++count_;
+    }
+
+    std::array<thread_usage, MAX_THREADS> usage_{};
+    std::array<counters, MAX_THREADS> last_{};
+    std::array<counters, MAX_THREADS> next_{};
+    std::size_t count_{};
+    std::size_t last_count_{};
+    bool truncated_{};
+    std::uint64_t window_cycles_{1};
+    tick_timer::time_point last_sample_{tick_timer::now()};
+#ifdef CONFIG_SCHED_THREAD_USAGE_ALL
+    struct cpu_counters
+    {
+        std::uint64_t busy;
+        std::uint64_t all;
+    };
+    std::array<cpu_usage, max_cpus> cpus_{};
+    std::array<cpu_counters, max_cpus> cpu_last_{};
+#endif
+};
+
+} // namespace zephyr
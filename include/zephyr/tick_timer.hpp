@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: Apache-2.0
 #pragma once
 #include <chrono>
+#include <type_traits>
 #include <zephyr/kernel.h>
 
 namespace zephyr
@@ -45,6 +46,79 @@ inline constexpr auto duration_until(const std::chrono::time_point<Clock, Durati
     return d < Duration::zero() ? Duration::zero() : d;
 }
 
+/// @brief  Converts a deadline to a kernel timeout. Deadlines of @ref tick_timer are passed
+///         to the kernel as absolute timeouts (when supported), so that the time elapsing
+///         until the kernel call doesn't postpone the wake-up.
+///         Deadlines of other clocks are converted to relative timeouts.
+/// @param  abs_time: the deadline
+/// @return the kernel timeout, K_NO_WAIT if the deadline has already passed
+template <class Clock, class Duration>
+inline k_timeout_t timeout_until(const std::chrono::time_point<Clock, Duration>& abs_time)
+{
+#ifdef CONFIG_TIMEOUT_64BIT
+    if constexpr (std::is_same_v<Clock, tick_timer>)
+    {
+        if (abs_time == std::chrono::time_point<Clock, Duration>::max())
+        {
+            return K_FOREVER;
+        }
+        const auto ticks =
+            to_ticks(std::chrono::ceil<tick_timer::duration>(abs_time.time_since_epoch()));
+        if (ticks <= ::k_uptime_ticks())
+        {
+            return K_NO_WAIT;
+        }
+        return K_TIMEOUT_ABS_TICKS(ticks);
+    }
+    else
+#endif
+    {
+        return to_timeout(duration_until(abs_time));
+    }
+}
+
 inline constexpr tick_timer::duration infinity{K_TICKS_FOREVER};
 
+namespace detail
+{
+/// @brief  Deadline representation of the timed calls that may wait several times,
+///         time_point::max() stands for waiting forever.
+inline tick_timer::time_point to_deadline(const tick_timer::duration& rel_time)
+{
+    return rel_time == infinity ? tick_timer::time_point::max() : tick_timer::now() + rel_time;
+}
+
+template <class Rep, class Period>
+inline tick_timer::time_point to_deadline(const std::chrono::duration<Rep, Period>& rel_time)
+{
+    return to_deadline(std::chrono::ceil<tick_timer::duration>(rel_time));
+}
+
+template <class Clock, class Duration>
+inline tick_timer::time_point to_deadline(const std::chrono::time_point<Clock, Duration>& abs_time)
+{
+    return to_deadline(duration_until(abs_time));
+}
+
+inline tick_timer::time_point to_deadline(const tick_timer::time_point& abs_time)
+{
+    return abs_time;
+}
+
+inline tick_timer::duration remaining(const tick_timer::time_point& deadline)
+{
+    return deadline == tick_timer::time_point::max() ? infinity : duration_until(deadline);
+}
+
+inline bool expired(const tick_timer::time_point& deadline)
+{
+    return (deadline != tick_timer::time_point::max()) and (tick_timer::now() >= deadline);
+}
+
+inline k_timeout_t deadline_timeout(const tick_timer::time_point& deadline)
+{
+    return deadline == tick_timer::time_point::max() ? K_FOREVER : timeout_until(deadline);
+}
+} // namespace detail
+
 } // namespace zephyr
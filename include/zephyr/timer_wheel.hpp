@@ -0,0 +1,291 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include "zephyr/cpu.hpp"
+#include "zephyr/work_queue.hpp"
+
+namespace zephyr
+{
+template <unsigned LEVELS>
+class timer_wheel;
+
+/// @brief  Intrusive timer of a @ref timer_wheel, embed it in the object that owns the deadline.
+///         The callback is invoked from the wheel's work queue.
+class timer_node
+{
+  public:
+    explicit timer_node(void (*fn)(timer_node*)) : callback_(fn) {}
+    timer_node(const timer_node&) = delete;
+    timer_node& operator=(const timer_node&) = delete;
+
+    bool is_armed() const { return ::sys_dnode_is_linked(&node_); }
+
+  private:
+    template <unsigned LEVELS>
+    friend class timer_wheel;
+
+    ::sys_dnode_t node_{};
+    std::uint64_t expires_{};
+    std::uint16_t slot_{};
+    void (*callback_)(timer_node*);
+};
+
+/// @brief  Hierarchical timer wheel, multiplexing any number of @ref timer_node deadlines
+///         onto a single delayable work item. Arming, re-arming and cancelling
+///         a timer is O(1), the expired timers are dispatched in batches per wheel tick.
+/// @tparam LEVELS: number of wheel levels, each covering 64 times the span of the previous one.
+///         Deadlines beyond resolution * 64^LEVELS are clamped to that.
+template <unsigned LEVELS = 4>
+class timer_wheel
+{
+    static_assert((LEVELS > 0) and (LEVELS <= 8));
+    static constexpr unsigned slot_bits = 6;
+    static constexpr std::size_t slots = 1U << slot_bits;
+    static constexpr std::uint64_t slot_mask = slots - 1;
+    static constexpr std::uint16_t pending_slot = std::numeric_limits<std::uint16_t>::max();
+    static constexpr std::uint64_t never = std::numeric_limits<std::uint64_t>::max();
+
+  public:
+    timer_wheel(const timer_wheel&) = delete;
+    timer_wheel& operator=(const timer_wheel&) = delete;
+
+    /// @brief  Creates an empty timer wheel.
+    /// @param  resolution: the wheel tick, deadlines are rounded up to its multiples
+    /// @param  queue: the work queue to dispatch the timer callbacks from
+    template <class Rep, class Period>
+    explicit timer_wheel(const std::chrono::duration<Rep, Period>& resolution,
+                         ::k_work_q& queue = system_work_queue())
+        : queue_(&queue),
+          resolution_(std::max<tick_timer::rep>(
+              std::chrono::ceil<tick_timer::duration>(resolution).count(), 1))
+    {
+        for (auto& slot : slots_)
+        {
+            ::sys_dlist_init(&slot);
+        }
+        ::sys_dlist_init(&expired_);
+        current_ = static_cast<std::uint64_t>(to_ticks(tick_timer::now())) / resolution_;
+    }
+
+    /// @brief  Arms the timer to expire at the deadline. An already armed timer is re-armed.
+    /// @param  timer: the timer to arm
+    /// @param  abs_time: the expiry time
+    /// @remark Thread and ISR context callable
+    void arm_until(timer_node& timer, const tick_timer::time_point& abs_time)
+    {
+        const auto ticks = std::max<tick_timer::rep>(to_ticks(abs_time), 0);
+        const auto now = static_cast<std::uint64_t>(to_ticks(tick_timer::now()));
+        critical_section cs(lock_);
+        unlink(timer);
+        if (count_ == 0)
+        {
+            // the wheel only advances while it has timers, catch up after idling
+            current_ = std::max(current_, now / resolution_);
+        }
+        timer.expires_ = (static_cast<std::uint64_t>(ticks) + resolution_ - 1) / resolution_;
+        link(timer);
+        if (timer.expires_ < scheduled_)
+        {
+            schedule(std::max(timer.expires_, current_));
+        }
+    }
+
+    /// @brief  Arms the timer to expire at the deadline. An already armed timer is re-armed.
+    /// @param  timer: the timer to arm
+    /// @param  abs_time: the expiry time
+    /// @remark Thread and ISR context callable
+    template <class Clock, class Duration>
+    void arm_until(timer_node& timer, const std::chrono::time_point<Clock, Duration>& abs_time)
+    {
+        arm_for(timer, duration_until(abs_time));
+    }
+
+    /// @brief  Arms the timer to expire after the duration. An already armed timer is re-armed.
+    /// @param  timer: the timer to arm
+    /// @param  rel_time: the time to expiry
+    /// @remark Thread and ISR context callable
+    template <class Rep, class Period>
+    void arm_for(timer_node& timer, const std::chrono::duration<Rep, Period>& rel_time)
+    {
+        arm_until(timer, tick_timer::now() + std::chrono::ceil<tick_timer::duration>(rel_time));
+    }
+
+    /// @brief  Disarms the timer, unless it's already being dispatched.
+    /// @param  timer: the timer to cancel
+    /// @return true if the timer was armed, false otherwise
+    /// @remark Thread and ISR context callable
+    bool cancel(timer_node& timer)
+    {
+        critical_section cs(lock_);
+        return unlink(timer);
+    }
+
+    /// @brief  The number of timers armed in the wheel.
+    std::size_t size() const { return count_; }
+
+  private:
+    void link(timer_node& timer)
+    {
+        const std::uint64_t delta = timer.expires_ - current_;
+        unsigned level = 0;
+        if (timer.expires_ < current_)
+        {
+            // already expired, dispatch with the next tick
+            timer.expires_ = current_;
+        }
+        else
+        {
+            while ((level < (LEVELS - 1)) and (delta >= (1ULL << (slot_bits * (level + 1)))))
+            {
+                ++level;
+            }
+            if (delta >= (1ULL << (slot_bits * LEVELS)))
+            {
+                timer.expires_ = current_ + (1ULL << (slot_bits * LEVELS)) - 1;
+            }
+        }
+        const std::size_t index = (timer.expires_ >> (slot_bits * level)) & slot_mask;
+        timer.slot_ = static_cast<std::uint16_t>(level * slots + index);
+        ::sys_dlist_append(&slots_[timer.slot_], &timer.node_);
+        occupied_[level] |= 1ULL << index;
+        ++count_;
+    }
+
+    bool unlink(timer_node& timer)
+    {
+        if (!timer.is_armed())
+        {
+            return false;
+        }
+        ::sys_dlist_remove(&timer.node_);
+        if (timer.slot_ != pending_slot)
+        {
+            if (::sys_dlist_is_empty(&slots_[timer.slot_]))
+            {
+                occupied_[timer.slot_ / slots] &= ~(1ULL << (timer.slot_ % slots));
+            }
+            --count_;
+        }
+        return true;
+    }
+
+    void cascade(unsigned level)
+    {
+        const std::size_t index = (current_ >> (slot_bits * level)) & slot_mask;
+        auto& slot = slots_[level * slots + index];
+        occupied_[level] &= ~(1ULL << index);
+        for (::sys_dnode_t* node; (node = ::sys_dlist_get(&slot)) != nullptr;)
+        {
+            --count_;
+            link(*CONTAINER_OF(node, timer_node, node_));
+        }
+    }
+
+    /// @brief  Moves the timers of the elapsed wheel ticks to the expired list,
+    ///         skipping the ticks without timers to expire or cascade.
+    void advance(std::uint64_t until)
+    {
+        while (current_ <= until)
+        {
+            const std::uint64_t next = next_event();
+            if (next > until)
+            {
+                current_ = until + 1;
+                return;
+            }
+            current_ = next;
+            const std::size_t index = current_ & slot_mask;
+            for (unsigned level = 1; (level < LEVELS) and
+                                     (((current_ >> (slot_bits * (level - 1))) & slot_mask) == 0);
+                 ++level)
+            {
+                cascade(level);
+            }
+            auto& slot = slots_[index];
+            occupied_[0] &= ~(1ULL << index);
+            for (::sys_dnode_t* node; (node = ::sys_dlist_get(&slot)) != nullptr;)
+            {
+                CONTAINER_OF(node, timer_node, node_)->slot_ = pending_slot;
+                ::sys_dlist_append(&expired_, node);
+                --count_;
+            }
+            ++current_;
+        }
+    }
+
+    /// @brief  Finds the next wheel tick that has timers to expire or cascade.
+    std::uint64_t next_event() const
+    {
+        if (count_ == 0)
+        {
+            return never;
+        }
+        const std::size_t index = current_ & slot_mask;
+        std::uint64_t distance = never;
+        if (occupied_[0] != 0)
+        {
+            distance = std::countr_zero(std::rotr(occupied_[0], static_cast<int>(index)));
+        }
+        for (unsigned level = 1; level < LEVELS; ++level)
+        {
+            if (occupied_[level] != 0)
+            {
+                distance = std::min<std::uint64_t>(distance, (slots - index) & slot_mask);
+                break;
+            }
+        }
+        return current_ + distance;
+    }
+
+    void schedule(std::uint64_t tick)
+    {
+        scheduled_ = tick;
+        if (tick == never)
+        {
+            return;
+        }
+        const tick_timer::time_point at{tick_timer::duration(tick * resolution_)};
+        work_.reschedule_to(*queue_, duration_until(at));
+    }
+
+    static void process(work_delayable* w)
+    {
+        auto* self = CONTAINER_OF(w, timer_wheel, work_);
+        const auto now = static_cast<std::uint64_t>(to_ticks(tick_timer::now()));
+        {
+            critical_section cs(self->lock_);
+            self->advance(now / self->resolution_);
+        }
+        for (;;)
+        {
+            timer_node* timer;
+            {
+                critical_section cs(self->lock_);
+                auto* node = ::sys_dlist_get(&self->expired_);
+                if (node == nullptr)
+                {
+                    self->schedule(self->next_event());
+                    break;
+                }
+                timer = CONTAINER_OF(node, timer_node, node_);
+            }
+            timer->callback_(timer);
+        }
+    }
+
+    work_delayable work_{&process};
+    ::k_work_q* queue_;
+    spinlock lock_{};
+    std::uint64_t resolution_;
+    std::uint64_t current_{};
+    std::uint64_t scheduled_{never};
+    std::size_t count_{};
+    std::uint64_t occupied_[LEVELS]{};
+    ::sys_dlist_t slots_[LEVELS * slots];
+    ::sys_dlist_t expired_;
+};
+
+} // namespace zephyr
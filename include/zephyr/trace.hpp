@@ -0,0 +1,213 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "zephyr/cpu.hpp"
+
+namespace zephyr
+{
+/// @brief  Binary event trace, enabled by CONFIG_ZEPHYR_MCPP_TRACE: fixed-size records
+///         in a ring buffer per CPU, to find timing bugs that printk() would hide.
+///         Recording costs a cycle counter read, an atomic increment and four stores,
+///         and it compiles to nothing when the trace is disabled.
+///         The wrappers record their message queue, semaphore and work submission operations,
+///         @ref ZEPHYR_MCPP_TRACE_THREAD_SWITCHES adds the thread switches.
+///         The buffers are written out with @ref dump, and scripts/trace_to_perfetto.py
+///         converts them to a trace viewable in Perfetto or chrome://tracing.
+namespace trace
+{
+/// @brief  The identifiers of the recorded events, the decoder interprets
+///         the records' arguments accordingly.
+enum class event : std::uint16_t
+{
+    /// args: the thread switched in
+    thread_switched_in,
+    /// args: the queue, the start of the call in cycles; status: the call's result
+    message_queue_post,
+    /// args: the queue, the start of the call in cycles; status: the call's result
+    message_queue_get,
+    /// args: the semaphore, the start of the call in cycles; status: the call's result
+    semaphore_acquire,
+    /// args: the semaphore, the count increment
+    semaphore_release,
+    /// args: the work item, the work queue; status: the call's result
+    work_submit,
+    /// the first identifier of the application's events, see @ref user_event
+    user = 0x100,
+};
+
+/// @brief  Identifier of an application event.
+/// @param  n: the application's event number
+constexpr event user_event(std::uint16_t n)
+{
+    return static_cast<event>(static_cast<std::uint16_t>(event::user) + n);
+}
+
+/// @brief  Trace record, as stored and dumped.
+struct record
+{
+    /// k_cycle_get_32() at the time of recording
+    std::uint32_t timestamp;
+    event id;
+    std::int16_t status;
+    std::uint32_t args[2];
+};
+static_assert(sizeof(record) == 16);
+
+/// @brief  Converts an object address to a record argument.
+inline std::uint32_t word(const void* ptr)
+{
+    return static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(ptr));
+}
+
+#ifdef CONFIG_ZEPHYR_MCPP_TRACE
+namespace detail
+{
+#ifdef CONFIG_ZEPHYR_MCPP_TRACE_RECORDS
+inline constexpr std::uint32_t records_per_cpu = CONFIG_ZEPHYR_MCPP_TRACE_RECORDS;
+#else
+inline constexpr std::uint32_t records_per_cpu = 512;
+#endif
+static_assert((records_per_cpu & (records_per_cpu - 1)) == 0, "must be a power of two");
+
+#ifdef CONFIG_MP_MAX_NUM_CPUS
+inline constexpr std::size_t max_cpus = CONFIG_MP_MAX_NUM_CPUS;
+#else
+inline constexpr std::size_t max_cpus = 1;
+#endif
+
+struct alignas(cache_line_size) ring
+{
+    /// the number of records ever reserved, only the last records_per_cpu are kept
+    std::atomic<std::uint32_t> head{};
+    record records[records_per_cpu]{};
+};
+
+inline ring rings[max_cpus]{};
+inline std::atomic<bool> recording{true};
+
+/// @brief  The header of the dumped trace, followed by each CPU's head index
+///         and records, in the native byte order.
+struct dump_header
+{
+    static constexpr std::uint32_t magic_value = 0x52544d5a; // "ZMTR"
+    std::uint32_t magic;
+    std::uint16_t version;
+    std::uint16_t record_size;
+    std::uint32_t cycles_per_sec;
+    std::uint32_t num_cpus;
+    std::uint32_t records_per_cpu;
+};
+} // namespace detail
+
+/// @brief  Records an event in the current CPU's ring, overwriting its oldest record.
+///         A thread migrating meanwhile records in the previous CPU's ring, which is safe.
+/// @param  id: the event's identifier
+/// @param  arg0: the event's first argument
+/// @param  arg1: the event's second argument
+/// @param  status: the event's status (e.g. the result of the traced call)
+/// @remark Thread and ISR context callable
+inline void emit(event id, std::uint32_t arg0 = 0, std::uint32_t arg1 = 0, int status = 0)
+{
+    if (!detail::recording.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+    detail::ring& ring = detail::rings[this_cpu::id()];
+    const std::uint32_t index = ring.head.fetch_add(1, std::memory_order_relaxed);
+    ring.records[index % detail::records_per_cpu] = {
+        ::k_cycle_get_32(), id, static_cast<std::int16_t>(status), {arg0, arg1}};
+}
+
+/// @brief  Records a call that may block: its start is taken at construction,
+///         the record is emitted at @ref end.
+class span
+{
+  public:
+    span() : start_(::k_cycle_get_32()) {}
+
+    /// @param  id: the event's identifier
+    /// @param  object: the object that the call operated on
+    /// @param  status: the result of the call
+    void end(event id, const void* object, int status) const
+    {
+        emit(id, word(object), start_, status);
+    }
+
+  private:
+    std::uint32_t start_;
+};
+
+/// @brief  Stops recording, e.g. when a fault is detected, to preserve the events leading to it.
+inline void stop()
+{
+    detail::recording.store(false, std::memory_order_relaxed);
+}
+
+/// @brief  Resumes recording.
+inline void start()
+{
+    detail::recording.store(true, std::memory_order_relaxed);
+}
+
+/// @brief  Discards all records. Stop recording before, as the records being written
+///         meanwhile could be kept.
+inline void clear()
+{
+    for (auto& ring : detail::rings)
+    {
+        ring.head.store(0, std::memory_order_relaxed);
+    }
+}
+
+/// @brief  Writes out the trace, for scripts/trace_to_perfetto.py to decode.
+///         Stop recording before, or the records being written meanwhile may be inconsistent.
+/// @param  write: callable with (const void* data, std::size_t size) parameters,
+///         that appends the data to the dump (e.g. sends it over UART, or writes it to flash)
+template <typename F>
+void dump(F&& write)
+{
+    const std::uint32_t num_cpus = std::min<std::uint32_t>(::arch_num_cpus(), detail::max_cpus);
+    const detail::dump_header header{detail::dump_header::magic_value,
+                                     1,
+                                     sizeof(record),
+                                     ::sys_clock_hw_cycles_per_sec(),
+                                     num_cpus,
+                                     detail::records_per_cpu};
+    write(static_cast<const void*>(&header), sizeof(header));
+    for (std::uint32_t cpu = 0; cpu < num_cpus; ++cpu)
+    {
+        const detail::ring& ring = detail::rings[cpu];
+        const std::uint32_t head = ring.head.load(std::memory_order_acquire);
+        write(static_cast<const void*>(&head), sizeof(head));
+        write(static_cast<const void*>(ring.records), sizeof(ring.records));
+    }
+}
+
+#else
+inline void emit(event, std::uint32_t = 0, std::uint32_t = 0, int = 0) {}
+
+class span
+{
+  public:
+    void end(event, const void*, int) const {}
+};
+#endif // CONFIG_ZEPHYR_MCPP_TRACE
+
+} // namespace trace
+} // namespace zephyr
+
+#ifdef CONFIG_ZEPHYR_MCPP_TRACE
+/// @brief  Defines the tracing hooks (CONFIG_TRACING_USER) that record the thread switches.
+///         Place it in one source file of the application.
+#define ZEPHYR_MCPP_TRACE_THREAD_SWITCHES()                                                        \
+    extern "C" void sys_trace_thread_switched_in_user(void)                                        \
+    {                                                                                              \
+        ::zephyr::trace::emit(::zephyr::trace::event::thread_switched_in,                          \
+                              ::zephyr::trace::word(::k_current_get()));                           \
+    }
+#else
+#define ZEPHYR_MCPP_TRACE_THREAD_SWITCHES()
+#endif
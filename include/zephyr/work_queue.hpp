@@ -1,18 +1,82 @@
 // SPDX-License-Identifier: Apache-2.0
 #pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
 #include "zephyr/message_queue.hpp"
 #include "zephyr/polling.hpp"
+#include "zephyr/thread.hpp"
+#include "zephyr/trace.hpp"
 
 namespace zephyr
 {
 
+/// @brief  Work queue with its own thread, so that its work items don't
+///         compete with the system work queue's ones.
+template <std::size_t STACK_SIZE>
+class work_queue final : public ::k_work_q
+{
+  public:
+    work_queue(const work_queue&) = delete;
+    work_queue& operator=(const work_queue&) = delete;
+
+    /// @brief  Starts the work queue thread.
+    /// @param  prio: the priority of the work queue thread
+    /// @param  name: the name of the work queue thread
+    /// @param  no_yield: whether to skip yielding between work items,
+    ///         cooperative priority threads may starve lower priority threads this way
+    explicit work_queue(zephyr::thread::priority prio, const char* name = nullptr,
+                        bool no_yield = false)
+    {
+        ::k_work_queue_config config{};
+        config.name = name;
+        config.no_yield = no_yield;
+        ::k_work_queue_init(this);
+        ::k_work_queue_start(this, stack_, K_KERNEL_STACK_SIZEOF(stack_), prio, &config);
+    }
+
+    zephyr::thread* get_thread()
+    {
+        return reinterpret_cast<zephyr::thread*>(::k_work_queue_thread_get(this));
+    }
+
+    /// @brief  Blocks until the queue has run out of work items.
+    /// @param  plug: whether to reject new submissions until @ref unplug is called
+    auto drain(bool plug = false) { return ::k_work_queue_drain(this, plug); }
+    auto unplug() { return ::k_work_queue_unplug(this); }
+
+  private:
+    K_KERNEL_STACK_MEMBER(stack_, STACK_SIZE);
+};
+
+inline ::k_work_q& system_work_queue()
+{
+    return ::k_sys_work_q;
+}
+
+namespace detail
+{
+/// @brief  Records the work item submission in the trace.
+/// @return the submission's result
+inline int traced_submit(const ::k_work* work, const ::k_work_q& queue, int status)
+{
+    trace::emit(trace::event::work_submit, trace::word(work), trace::word(&queue), status);
+    return status;
+}
+} // namespace detail
+
 struct work final : public ::k_work
 {
     explicit work(void (*fn)(work*))
     {
         ::k_work_init(this, reinterpret_cast<k_work_handler_t>(fn));
     }
-    auto submit() { return ::k_work_submit(this); }
+    auto submit() { return detail::traced_submit(this, ::k_sys_work_q, ::k_work_submit(this)); }
+    auto submit_to(::k_work_q& queue)
+    {
+        return detail::traced_submit(this, queue, ::k_work_submit_to_queue(&queue, this));
+    }
     auto cancel() { return ::k_work_cancel(this); }
     auto is_pending() const { return ::k_work_is_pending(this); }
 };
@@ -29,6 +93,12 @@ struct work_poll final : public ::k_work_poll
         return ::k_work_poll_submit(this, events.data(), static_cast<int>(events.size()),
                                     to_timeout(timeout));
     }
+    auto submit_to(::k_work_q& queue, const std::span<poll_event>& events,
+                   tick_timer::duration timeout)
+    {
+        return ::k_work_poll_submit_to_queue(&queue, this, events.data(),
+                                             static_cast<int>(events.size()), to_timeout(timeout));
+    }
 
     auto cancel() { return ::k_work_poll_cancel(this); }
 };
@@ -57,11 +127,198 @@ struct work_delayable final : public ::k_work_delayable
     }
     template <class Rep, class Period>
     int reschedule(const std::chrono::duration<Rep, Period>& rel_time)
+    {
+        return ::k_work_reschedule(this, to_timeout(rel_time));
+    }
+    template <class Rep, class Period>
+    int schedule_to(::k_work_q& queue, const std::chrono::duration<Rep, Period>& rel_time)
+    {
+        return ::k_work_schedule_for_queue(&queue, this, to_timeout(rel_time));
+    }
+    template <class Rep, class Period>
+    int reschedule_to(::k_work_q& queue, const std::chrono::duration<Rep, Period>& rel_time)
+    {
+        return ::k_work_reschedule_for_queue(&queue, this, to_timeout(rel_time));
+    }
+
+    auto cancel() { return ::k_work_cancel_delayable(this); }
+};
+
+namespace detail
+{
+/// @brief  Type-erased void() callable, stored inline without heap allocation.
+template <std::size_t CAPACITY>
+class inline_function
+{
+  public:
+    inline_function() = default;
+    template <typename F>
+    explicit inline_function(F&& fn)
+    {
+        emplace(std::forward<F>(fn));
+    }
+    ~inline_function() { reset(); }
+    inline_function(const inline_function&) = delete;
+    inline_function& operator=(const inline_function&) = delete;
+
+    /// @brief  Replaces the stored callable.
+    template <typename F, typename Fn = std::decay_t<F>>
+    void emplace(F&& fn)
+    {
+        static_assert(std::is_invocable_v<Fn&>, "the callable must be invocable without arguments");
+        static_assert(sizeof(Fn) <= CAPACITY, "the callable doesn't fit, increase the capacity");
+        static_assert(alignof(Fn) <= alignof(std::max_align_t));
+        reset();
+        new (storage_) Fn(std::forward<F>(fn));
+        invoke_ = [](void* p) { (*static_cast<Fn*>(p))(); };
+        if constexpr (!std::is_trivially_destructible_v<Fn>)
+        {
+            destroy_ = [](void* p) { static_cast<Fn*>(p)->~Fn(); };
+        }
+    }
+
+    void reset()
+    {
+        if (destroy_ != nullptr)
+        {
+            destroy_(storage_);
+        }
+        invoke_ = nullptr;
+        destroy_ = nullptr;
+    }
+
+    explicit operator bool() const { return invoke_ != nullptr; }
+
+    void operator()() { invoke_(storage_); }
+
+  private:
+    alignas(std::max_align_t) std::byte storage_[CAPACITY];
+    void (*invoke_)(void*){};
+    void (*destroy_)(void*){};
+};
+} // namespace detail
+
+/// @brief  Work item that runs the callable (e.g. a capturing lambda) it was constructed with.
+/// @tparam CAPACITY: the inline storage size of the callable
+template <std::size_t CAPACITY = 2 * sizeof(void*)>
+class callable_work final : public ::k_work
+{
+  public:
+    template <typename F>
+    explicit callable_work(F&& fn) : fn_(std::forward<F>(fn))
+    {
+        ::k_work_init(this, &invoke);
+    }
+    callable_work(const callable_work&) = delete;
+    callable_work& operator=(const callable_work&) = delete;
+
+    auto submit() { return detail::traced_submit(this, ::k_sys_work_q, ::k_work_submit(this)); }
+    auto submit_to(::k_work_q& queue)
+    {
+        return detail::traced_submit(this, queue, ::k_work_submit_to_queue(&queue, this));
+    }
+    auto cancel() { return ::k_work_cancel(this); }
+    auto is_pending() const { return ::k_work_is_pending(this); }
+
+  private:
+    static void invoke(::k_work* w) { static_cast<callable_work*>(w)->fn_(); }
+
+    detail::inline_function<CAPACITY> fn_;
+};
+
+/// @brief  Work poll item that runs the callable (e.g. a capturing lambda)
+///         it was constructed with.
+/// @tparam CAPACITY: the inline storage size of the callable
+template <std::size_t CAPACITY = 2 * sizeof(void*)>
+class callable_work_poll final : public ::k_work_poll
+{
+  public:
+    template <typename F>
+    explicit callable_work_poll(F&& fn) : fn_(std::forward<F>(fn))
+    {
+        ::k_work_poll_init(this, &invoke);
+    }
+    callable_work_poll(const callable_work_poll&) = delete;
+    callable_work_poll& operator=(const callable_work_poll&) = delete;
+
+    auto submit(const std::span<poll_event>& events, tick_timer::duration timeout)
+    {
+        return ::k_work_poll_submit(this, events.data(), static_cast<int>(events.size()),
+                                    to_timeout(timeout));
+    }
+    auto submit_to(::k_work_q& queue, const std::span<poll_event>& events,
+                   tick_timer::duration timeout)
+    {
+        return ::k_work_poll_submit_to_queue(&queue, this, events.data(),
+                                             static_cast<int>(events.size()), to_timeout(timeout));
+    }
+
+    auto cancel() { return ::k_work_poll_cancel(this); }
+
+  private:
+    static void invoke(::k_work* w)
+    {
+        static_cast<callable_work_poll*>(CONTAINER_OF(w, ::k_work_poll, work))->fn_();
+    }
+
+    detail::inline_function<CAPACITY> fn_;
+};
+
+/// @brief  Delayable work item that runs the callable (e.g. a capturing lambda)
+///         it was constructed with.
+/// @tparam CAPACITY: the inline storage size of the callable
+template <std::size_t CAPACITY = 2 * sizeof(void*)>
+class callable_work_delayable final : public ::k_work_delayable
+{
+  public:
+    template <typename F>
+    explicit callable_work_delayable(F&& fn) : fn_(std::forward<F>(fn))
+    {
+        ::k_work_init_delayable(this, &invoke);
+    }
+    callable_work_delayable(const callable_work_delayable&) = delete;
+    callable_work_delayable& operator=(const callable_work_delayable&) = delete;
+
+    auto is_pending() const { return ::k_work_delayable_is_pending(this); }
+
+    auto expiration() const
+    {
+        return tick_timer::time_point(tick_timer::duration(::k_work_delayable_expires_get(this)));
+    }
+    auto remaining_time() const
+    {
+        return tick_timer::duration(::k_work_delayable_remaining_get(this));
+    }
+    template <class Rep, class Period>
+    int schedule(const std::chrono::duration<Rep, Period>& rel_time)
     {
         return ::k_work_schedule(this, to_timeout(rel_time));
     }
+    template <class Rep, class Period>
+    int reschedule(const std::chrono::duration<Rep, Period>& rel_time)
+    {
+        return ::k_work_reschedule(this, to_timeout(rel_time));
+    }
+    template <class Rep, class Period>
+    int schedule_to(::k_work_q& queue, const std::chrono::duration<Rep, Period>& rel_time)
+    {
+        return ::k_work_schedule_for_queue(&queue, this, to_timeout(rel_time));
+    }
+    template <class Rep, class Period>
+    int reschedule_to(::k_work_q& queue, const std::chrono::duration<Rep, Period>& rel_time)
+    {
+        return ::k_work_reschedule_for_queue(&queue, this, to_timeout(rel_time));
+    }
 
     auto cancel() { return ::k_work_cancel_delayable(this); }
+
+  private:
+    static void invoke(::k_work* w)
+    {
+        static_cast<callable_work_delayable*>(::k_work_delayable_from_work(w))->fn_();
+    }
+
+    detail::inline_function<CAPACITY> fn_;
 };
 
 } // namespace zephyr
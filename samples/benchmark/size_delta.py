@@ -0,0 +1,39 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: Apache-2.0
+"""Reports the code size of the bench_cpp_* functions relative to their bench_raw_* pairs."""
+import argparse
+import re
+import subprocess
+import sys
+
+SYMBOL = re.compile(r"^[0-9a-fA-F]+\s+([0-9a-fA-F]+)\s+[tTwW]\s+bench_(raw|cpp)_(\w+)$")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--nm", default="nm", help="the nm tool of the toolchain")
+    parser.add_argument("elf", help="the benchmark executable")
+    args = parser.parse_args()
+
+    output = subprocess.run([args.nm, "--print-size", args.elf], check=True,
+                            capture_output=True, text=True).stdout
+    sizes = {}
+    for line in output.splitlines():
+        match = SYMBOL.match(line.strip())
+        if match:
+            size, kind, name = match.groups()
+            sizes.setdefault(name, {})[kind] = int(size, 16)
+
+    print(f"{'code size [B]':<24}{'raw':>8}{'cpp':>8}{'delta':>8}")
+    failed = False
+    for name, pair in sorted(sizes.items()):
+        if len(pair) != 2:
+            print(f"{name:<24}missing pair, was a function inlined?")
+            failed = True
+            continue
+        print(f"{name:<24}{pair['raw']:>8}{pair['cpp']:>8}{pair['cpp'] - pair['raw']:>+8}")
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
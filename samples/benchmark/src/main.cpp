@@ -0,0 +1,362 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <cstdint>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include "zephyr/event_group.hpp"
+#include "zephyr/message_queue.hpp"
+#include "zephyr/semaphore.hpp"
+#include "zephyr/thread.hpp"
+#include "zephyr/work_queue.hpp"
+
+using namespace std::chrono_literals;
+
+namespace
+{
+constexpr unsigned iterations = 10000;
+constexpr unsigned sleep_iterations = 100;
+constexpr auto sleep_time = 500us;
+constexpr std::size_t queue_depth = 16;
+
+struct message
+{
+    std::uint32_t data[16];
+};
+
+K_THREAD_STACK_DEFINE(peer_stack, 2048);
+::k_thread peer_thread;
+
+/// @brief  Runs the other side of a ping-pong benchmark on a higher priority thread.
+void start_peer(k_thread_entry_t entry)
+{
+    ::k_thread_create(&peer_thread, peer_stack, K_THREAD_STACK_SIZEOF(peer_stack), entry, nullptr,
+                      nullptr, nullptr, ::k_thread_priority_get(::k_current_get()) - 1, 0,
+                      K_NO_WAIT);
+}
+
+void stop_peer()
+{
+    ::k_thread_join(&peer_thread, K_FOREVER);
+}
+
+template <typename F>
+std::uint64_t measure(F&& fn)
+{
+    const auto start = ::k_cycle_get_64();
+    fn();
+    return ::k_cycle_get_64() - start;
+}
+
+void report(const char* name, std::uint64_t raw_cycles, std::uint64_t cpp_cycles, unsigned count)
+{
+    const auto raw = static_cast<unsigned long long>(raw_cycles / count);
+    const auto cpp = static_cast<unsigned long long>(cpp_cycles / count);
+    printk("%-24s%10llu%10llu%+10lld%10llu%10llu\n", name, raw, cpp,
+           static_cast<long long>(cpp - raw),
+           static_cast<unsigned long long>(::k_cyc_to_ns_floor64(raw)),
+           static_cast<unsigned long long>(::k_cyc_to_ns_floor64(cpp)));
+}
+
+message msg{};
+char raw_msgq_buffer[queue_depth * sizeof(message)] alignas(message);
+char raw_reply_buffer[queue_depth * sizeof(message)] alignas(message);
+::k_msgq raw_msgq;
+::k_msgq raw_reply;
+zephyr::message_queue_instance<message, queue_depth> cpp_msgq;
+zephyr::message_queue_instance<message, queue_depth> cpp_reply;
+
+::k_sem raw_ping;
+::k_sem raw_pong;
+zephyr::binary_semaphore cpp_ping{0};
+zephyr::binary_semaphore cpp_pong{0};
+
+::k_event raw_events;
+zephyr::event_group cpp_events;
+constexpr zephyr::events ping_flag = 1;
+constexpr zephyr::events pong_flag = 2;
+
+std::uint64_t work_submitted;
+std::uint64_t work_latency;
+::k_sem work_done;
+} // namespace
+
+// The measured operations are kept out of line in wrapper/raw API pairs,
+// so size_delta.py can compare their code size.
+extern "C"
+{
+__attribute__((noinline)) void bench_raw_msgq_post(::k_msgq& q, const message& m)
+{
+    ::k_msgq_put(&q, &m, K_FOREVER);
+}
+__attribute__((noinline)) void bench_cpp_msgq_post(zephyr::message_queue<message>& q,
+                                                   const message& m)
+{
+    q.post(m);
+}
+__attribute__((noinline)) void bench_raw_msgq_get(::k_msgq& q, message& m)
+{
+    ::k_msgq_get(&q, &m, K_FOREVER);
+}
+__attribute__((noinline)) void bench_cpp_msgq_get(zephyr::message_queue<message>& q, message& m)
+{
+    q.get(m);
+}
+__attribute__((noinline)) void bench_raw_sem_release(::k_sem& s)
+{
+    ::k_sem_give(&s);
+}
+__attribute__((noinline)) void bench_cpp_sem_release(zephyr::binary_semaphore& s)
+{
+    s.release();
+}
+__attribute__((noinline)) void bench_raw_sem_acquire(::k_sem& s)
+{
+    ::k_sem_take(&s, K_FOREVER);
+}
+__attribute__((noinline)) void bench_cpp_sem_acquire(zephyr::binary_semaphore& s)
+{
+    s.acquire();
+}
+__attribute__((noinline)) void bench_raw_event_set(::k_event& e, std::uint32_t flags)
+{
+    ::k_event_post(&e, flags);
+}
+__attribute__((noinline)) void bench_cpp_event_set(zephyr::event_group& e, zephyr::events flags)
+{
+    e.set(flags);
+}
+__attribute__((noinline)) std::uint32_t bench_raw_event_wait(::k_event& e, std::uint32_t flags)
+{
+    return ::k_event_wait_safe(&e, flags, false, K_FOREVER);
+}
+__attribute__((noinline)) zephyr::events bench_cpp_event_wait(zephyr::event_group& e,
+                                                               zephyr::events flags)
+{
+    return e.wait_any(flags);
+}
+__attribute__((noinline)) void bench_raw_work_submit(::k_work& w)
+{
+    ::k_work_submit(&w);
+}
+__attribute__((noinline)) void bench_cpp_work_submit(zephyr::work& w)
+{
+    w.submit();
+}
+__attribute__((noinline)) void bench_raw_sleep(std::int32_t us)
+{
+    ::k_sleep(K_USEC(us));
+}
+__attribute__((noinline)) void bench_cpp_sleep(std::chrono::microseconds us)
+{
+    zephyr::this_thread::sleep_for(us);
+}
+}
+
+namespace
+{
+void msgq_throughput()
+{
+    const auto raw = measure([] {
+        for (unsigned i = 0; i < iterations; i += queue_depth)
+        {
+            for (unsigned j = 0; j < queue_depth; ++j)
+            {
+                bench_raw_msgq_post(raw_msgq, msg);
+            }
+            for (unsigned j = 0; j < queue_depth; ++j)
+            {
+                bench_raw_msgq_get(raw_msgq, msg);
+            }
+        }
+    });
+    const auto cpp = measure([] {
+        for (unsigned i = 0; i < iterations; i += queue_depth)
+        {
+            for (unsigned j = 0; j < queue_depth; ++j)
+            {
+                bench_cpp_msgq_post(cpp_msgq, msg);
+            }
+            for (unsigned j = 0; j < queue_depth; ++j)
+            {
+                bench_cpp_msgq_get(cpp_msgq, msg);
+            }
+        }
+    });
+    report("msgq post+get", raw, cpp, iterations);
+}
+
+void msgq_round_trip()
+{
+    start_peer([](void*, void*, void*) {
+        message m;
+        for (unsigned i = 0; i < iterations; ++i)
+        {
+            bench_raw_msgq_get(raw_msgq, m);
+            bench_raw_msgq_post(raw_reply, m);
+        }
+    });
+    const auto raw = measure([] {
+        for (unsigned i = 0; i < iterations; ++i)
+        {
+            bench_raw_msgq_post(raw_msgq, msg);
+            bench_raw_msgq_get(raw_reply, msg);
+        }
+    });
+    stop_peer();
+
+    start_peer([](void*, void*, void*) {
+        message m;
+        for (unsigned i = 0; i < iterations; ++i)
+        {
+            bench_cpp_msgq_get(cpp_msgq, m);
+            bench_cpp_msgq_post(cpp_reply, m);
+        }
+    });
+    const auto cpp = measure([] {
+        for (unsigned i = 0; i < iterations; ++i)
+        {
+            bench_cpp_msgq_post(cpp_msgq, msg);
+            bench_cpp_msgq_get(cpp_reply, msg);
+        }
+    });
+    stop_peer();
+    report("msgq round-trip", raw, cpp, iterations);
+}
+
+void semaphore_ping_pong()
+{
+    start_peer([](void*, void*, void*) {
+        for (unsigned i = 0; i < iterations; ++i)
+        {
+            bench_raw_sem_acquire(raw_ping);
+            bench_raw_sem_release(raw_pong);
+        }
+    });
+    const auto raw = measure([] {
+        for (unsigned i = 0; i < iterations; ++i)
+        {
+            bench_raw_sem_release(raw_ping);
+            bench_raw_sem_acquire(raw_pong);
+        }
+    });
+    stop_peer();
+
+    start_peer([](void*, void*, void*) {
+        for (unsigned i = 0; i < iterations; ++i)
+        {
+            bench_cpp_sem_acquire(cpp_ping);
+            bench_cpp_sem_release(cpp_pong);
+        }
+    });
+    const auto cpp = measure([] {
+        for (unsigned i = 0; i < iterations; ++i)
+        {
+            bench_cpp_sem_release(cpp_ping);
+            bench_cpp_sem_acquire(cpp_pong);
+        }
+    });
+    stop_peer();
+    report("semaphore ping-pong", raw, cpp, iterations);
+}
+
+void event_group_set_wait()
+{
+    start_peer([](void*, void*, void*) {
+        for (unsigned i = 0; i < iterations; ++i)
+        {
+            bench_raw_event_wait(raw_events, ping_flag);
+            bench_raw_event_set(raw_events, pong_flag);
+        }
+    });
+    const auto raw = measure([] {
+        for (unsigned i = 0; i < iterations; ++i)
+        {
+            bench_raw_event_set(raw_events, ping_flag);
+            bench_raw_event_wait(raw_events, pong_flag);
+        }
+    });
+    stop_peer();
+
+    start_peer([](void*, void*, void*) {
+        for (unsigned i = 0; i < iterations; ++i)
+        {
+            bench_cpp_event_wait(cpp_events, ping_flag);
+            bench_cpp_event_set(cpp_events, pong_flag);
+        }
+    });
+    const auto cpp = measure([] {
+        for (unsigned i = 0; i < iterations; ++i)
+        {
+            bench_cpp_event_set(cpp_events, ping_flag);
+            bench_cpp_event_wait(cpp_events, pong_flag);
+        }
+    });
+    stop_peer();
+    report("event_group set+wait", raw, cpp, iterations);
+}
+
+void work_handler()
+{
+    work_latency += ::k_cycle_get_64() - work_submitted;
+    ::k_sem_give(&work_done);
+}
+
+void work_submit_to_execute()
+{
+    static ::k_work raw_work;
+    ::k_work_init(&raw_work, [](::k_work*) { work_handler(); });
+    static zephyr::work cpp_work{[](zephyr::work*) { work_handler(); }};
+
+    work_latency = 0;
+    for (unsigned i = 0; i < iterations; ++i)
+    {
+        work_submitted = ::k_cycle_get_64();
+        bench_raw_work_submit(raw_work);
+        ::k_sem_take(&work_done, K_FOREVER);
+    }
+    const auto raw = work_latency;
+
+    work_latency = 0;
+    for (unsigned i = 0; i < iterations; ++i)
+    {
+        work_submitted = ::k_cycle_get_64();
+        bench_cpp_work_submit(cpp_work);
+        ::k_sem_take(&work_done, K_FOREVER);
+    }
+    const auto cpp = work_latency;
+    report("work submit-to-execute", raw, cpp, iterations);
+}
+
+void sleep_accuracy()
+{
+    const auto requested = ::k_us_to_cyc_ceil64(sleep_time.count());
+    std::uint64_t raw = 0;
+    std::uint64_t cpp = 0;
+    for (unsigned i = 0; i < sleep_iterations; ++i)
+    {
+        raw += measure([] { bench_raw_sleep(sleep_time.count()); }) - requested;
+        cpp += measure([] { bench_cpp_sleep(sleep_time); }) - requested;
+    }
+    report("sleep_for oversleep", raw, cpp, sleep_iterations);
+}
+} // namespace
+
+int main()
+{
+    ::k_msgq_init(&raw_msgq, raw_msgq_buffer, sizeof(message), queue_depth);
+    ::k_msgq_init(&raw_reply, raw_reply_buffer, sizeof(message), queue_depth);
+    ::k_sem_init(&raw_ping, 0, 1);
+    ::k_sem_init(&raw_pong, 0, 1);
+    ::k_sem_init(&work_done, 0, 1);
+    ::k_event_init(&raw_events);
+
+    printk("%-24s%10s%10s%10s%10s%10s\n", "[cycles/op]", "raw", "cpp", "delta", "raw ns",
+           "cpp ns");
+    msgq_throughput();
+    msgq_round_trip();
+    semaphore_ping_pong();
+    event_group_set_wait();
+    work_submit_to_execute();
+    sleep_accuracy();
+    printk("benchmark done\n");
+    return 0;
+}
@@ -0,0 +1,175 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: Apache-2.0
+"""Converts a zephyr::trace::dump() output to a Chrome JSON trace, for Perfetto or chrome://tracing.
+
+Each CPU gets a track showing the running threads (when the thread switches are recorded),
+the recorded operations are shown on the track of the thread that made them.
+"""
+import argparse
+import json
+import re
+import struct
+import sys
+
+MAGIC = 0x52544D5A
+HEADER = "IHHIII"
+RECORD = "IHhII"
+
+# the values of zephyr::trace::event
+THREAD_SWITCHED_IN = 0
+SEMAPHORE_RELEASE = 4
+WORK_SUBMIT = 5
+USER = 0x100
+# the events that record a call, with its start time in the second argument
+SPANS = {1: "message_queue post", 2: "message_queue get", 3: "semaphore acquire"}
+INSTANTS = {SEMAPHORE_RELEASE: "semaphore release", WORK_SUBMIT: "work submit"}
+
+CPUS_PID = 0
+THREADS_PID = 1
+
+
+def load(data):
+    """Returns the cycle counter frequency, and the records of each CPU, oldest first."""
+    for order in "<>":
+        if struct.unpack_from(order + "I", data)[0] == MAGIC:
+            break
+    else:
+        raise ValueError("not a trace dump")
+    header = struct.Struct(order + HEADER)
+    _, version, record_size, cycles_per_sec, num_cpus, records_per_cpu = header.unpack_from(data)
+    if version != 1 or record_size != struct.calcsize(RECORD):
+        raise ValueError(f"unsupported trace version {version}")
+    record = struct.Struct(order + RECORD)
+    offset = header.size
+    cpus = []
+    for _ in range(num_cpus):
+        (head,) = struct.unpack_from(order + "I", data, offset)
+        offset += 4
+        count = min(head, records_per_cpu)
+        records = [record.unpack_from(data, offset + (index % records_per_cpu) * record_size)
+                   for index in range(head - count, head)]
+        offset += records_per_cpu * record_size
+        cpus.append(records)
+    return cycles_per_sec, cpus
+
+
+def unwrap(records):
+    """Extends the 32-bit cycle timestamps of a CPU's records, assuming no gap of half a wrap.
+
+    The records of a CPU are only roughly ordered (an ISR may record between another writer's
+    slot reservation and its timestamp, a migrated thread may write the previous CPU's ring),
+    so only a backwards step of more than half the range counts as a wrap.
+    """
+    result = []
+    previous = None
+    for record in records:
+        if previous is None:
+            current = record[0]
+        else:
+            delta = (record[0] - previous[0]) & 0xFFFFFFFF
+            if delta > 1 << 31:
+                delta -= 1 << 32
+            current = previous[1] + delta
+        previous = (record[0], current)
+        result.append(current)
+    return result
+
+
+def convert(cycles_per_sec, cpus, names):
+    def us(cycles):
+        return cycles * 1e6 / cycles_per_sec
+
+    events = [{"ph": "M", "pid": CPUS_PID, "name": "process_name", "args": {"name": "CPUs"}},
+              {"ph": "M", "pid": THREADS_PID, "name": "process_name", "args": {"name": "threads"}}]
+    threads = set()
+    # align the CPUs' unwrapped timelines on their last records, which are the most recent
+    times = [unwrap(records) for records in cpus]
+    reference = next((t[-1] for t in times if t), 0)
+    for t in times:
+        if t:
+            shift = round((reference - t[-1]) / (1 << 32)) * (1 << 32)
+            t[:] = [time + shift for time in t]
+    start = min((min(t) for t in times if t), default=0)
+
+    for cpu, (records, stamps) in enumerate(zip(cpus, times)):
+        events.append({"ph": "M", "pid": CPUS_PID, "tid": cpu, "name": "thread_name",
+                       "args": {"name": f"CPU {cpu}"}})
+        # the records made before the first thread switch are attributed to the CPU
+        current = f"CPU {cpu} thread"
+        switched_at = None
+        for (timestamp, event, status, arg0, arg1), time in zip(records, stamps):
+            ts = us(time - start)
+            if event == THREAD_SWITCHED_IN:
+                if switched_at is not None:
+                    events.append({"ph": "X", "pid": CPUS_PID, "tid": cpu, "name": current,
+                                   "ts": switched_at, "dur": ts - switched_at})
+                current = f"thread 0x{arg0:08x}"
+                switched_at = ts
+                threads.add(current)
+                continue
+            common = {"pid": THREADS_PID, "tid": current, "args": {"cpu": cpu}}
+            threads.add(current)
+            if event in SPANS:
+                # the start cycles are truncated, like the timestamp
+                duration = (timestamp - arg1) & 0xFFFFFFFF
+                common["args"].update(object=f"0x{arg0:08x}", result=status)
+                events.append(dict(common, ph="X", name=SPANS[event],
+                                   ts=ts - us(duration), dur=us(duration)))
+            elif event in INSTANTS:
+                if event == SEMAPHORE_RELEASE:
+                    common["args"].update(object=f"0x{arg0:08x}", update=arg1)
+                else:
+                    common["args"].update(work=f"0x{arg0:08x}", queue=f"0x{arg1:08x}",
+                                          result=status)
+                events.append(dict(common, ph="i", s="t", name=INSTANTS[event], ts=ts))
+            else:
+                name = names.get(event - USER, f"user {event - USER}") if event >= USER \
+                    else f"event {event}"
+                common["args"].update(arg0=arg0, arg1=arg1, status=status)
+                events.append(dict(common, ph="i", s="t", name=name, ts=ts))
+        if switched_at is not None:
+            events.append({"ph": "X", "pid": CPUS_PID, "tid": cpu, "name": current,
+                           "ts": switched_at, "dur": us(stamps[-1] - start) - switched_at})
+
+    # Chrome traces use numeric thread ids, the tracks are named after the threads
+    tids = {name: index for index, name in enumerate(sorted(threads))}
+    for event in events:
+        if event.get("pid") == THREADS_PID and "tid" in event:
+            event["tid"] = tids[event["tid"]]
+    events.extend({"ph": "M", "pid": THREADS_PID, "tid": tid, "name": "thread_name",
+                   "args": {"name": name}} for name, tid in tids.items())
+    return {"traceEvents": events, "displayTimeUnit": "ns"}
+
+
+def read_dump(path):
+    """Reads a binary dump, or its hex digits (e.g. captured from a console, or xxd -p)."""
+    with open(path, "rb") as file:
+        data = file.read()
+    if re.fullmatch(rb"[0-9a-fA-F\s]+", data):
+        return bytes.fromhex(re.sub(rb"\s", b"", data).decode())
+    return data
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("dump", help="the trace dump, binary or hex bytes")
+    parser.add_argument("-o", "--output", default="-", help="the JSON trace file")
+    parser.add_argument("--names", help="JSON object mapping the user event numbers to names")
+    args = parser.parse_args()
+
+    names = {}
+    if args.names:
+        with open(args.names) as file:
+            names = {int(number): name for number, name in json.load(file).items()}
+    cycles_per_sec, cpus = load(read_dump(args.dump))
+    trace = convert(cycles_per_sec, cpus, names)
+    if args.output == "-":
+        json.dump(trace, sys.stdout)
+    else:
+        with open(args.output, "w") as file:
+            json.dump(trace, file)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())